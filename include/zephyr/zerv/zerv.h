@@ -24,6 +24,7 @@
  *===============================================================================================*/
 #include <zephyr/zerv/zerv_internal.h>
 #include <zephyr/sys/slist.h>
+#include <zephyr/init.h>
 
 /*=================================================================================================
  * ZERVICE MACROS
@@ -75,23 +76,110 @@
  * @param heap_size The size of the heap of the service. The heap is used to store the command
  * inputs and outputs while they are being processed.
  */
-#define ZERV_DEF(zervice_name, heap_size)                                                          \
+#define ZERV_DEF(zervice_name, heap_size) __ZERV_DEF(zervice_name, heap_size, NULL, NULL, 1)
+
+/**
+ * @brief Macro for defining a zervice that has no thread of its own, but is run as an actor by
+ * one of the shared worker threads of the zervice pool whenever it has requests queued.
+ *
+ * @param zervice The name of the zervice. This should be the same name as declared with the
+ * ZERV_DECL macro.
+ * @param heap_size The size of the heap of the zervice. The heap is used to store the request
+ * inputs and outputs while they are being processed.
+ * @param on_init_cb The callback function that is called by a worker thread before the zervice
+ * handles its first request.
+ *
+ * @note Requires CONFIG_ZERV_POOL. A pooled zervice is never run by two workers at once, but may
+ * be run by a different worker every time. Its handlers share the stacks of the workers and
+ * should not block, as a blocked handler keeps a worker from the other pooled zervices. A pooled
+ * zervice can not wait on events. If on_init_cb fails, the commands to the zervice return
+ * ZERV_RC_ERROR and its messages are dropped.
+ */
+#define ZERV_DEF_POOLED(zervice, heap_size, on_init_cb)                                            \
+	BUILD_ASSERT(IS_ENABLED(CONFIG_ZERV_POOL), "Pooled zervices require CONFIG_ZERV_POOL");    \
+	static zerv_actor_t __##zervice##_actor = {                                                \
+		.serv = &zervice,                                                                  \
+		.scheduled = ATOMIC_INIT(0),                                                       \
+		.init_pending = ATOMIC_INIT(1),                                                    \
+		.init_cb = on_init_cb,                                                             \
+	};                                                                                         \
+	__ZERV_DEF(zervice, heap_size, zerv_internal_pool_schedule, &__##zervice##_actor, 0);      \
+	static int __##zervice##_pool_start(void)                                                  \
+	{                                                                                          \
+		zerv_internal_pool_schedule(&zervice);                                             \
+		return 0;                                                                          \
+	}                                                                                          \
+	SYS_INIT(__##zervice##_pool_start, APPLICATION, 99)
+
+/**
+ * @brief Macro for defining a zervice that has no thread of its own, but is run by a work queue
+ * whenever it has requests queued.
+ *
+ * @param zervice The name of the zervice. This should be the same name as declared with the
+ * ZERV_DECL macro.
+ * @param heap_size The size of the heap of the zervice. The heap is used to store the request
+ * inputs and outputs while they are being processed.
+ * @param work_queue Pointer to the work queue to run the zervice on, or NULL for the system work
+ * queue.
+ *
+ * @note The handlers run on the thread of the work queue and should not block, as a blocked
+ * handler delays all other work on the queue. A work queue zervice can not wait on events.
+ */
+#define ZERV_DEF_WORKQ(zervice, heap_size, work_queue)                                             \
+	static zerv_work_t __##zervice##_work = {                                                  \
+		.work = Z_WORK_INITIALIZER(zerv_internal_workq_handler),                           \
+		.workq = work_queue,                                                               \
+		.serv = &zervice,                                                                  \
+	};                                                                                         \
+	__ZERV_DEF(zervice, heap_size, zerv_internal_workq_submit, &__##zervice##_work, 1)
+
+// A zervice that is not initialized by its executor is initialized from boot.
+#define __ZERV_DEF(zervice_name, heap_size, enqueue_hook, zervice_executor, initialized)           \
+	__ZERV_INSTANCE_DEF(zervice_name, zervice_name, heap_size, enqueue_hook, zervice_executor, \
+			    NULL, NULL, NULL, initialized, __##zervice_name##_const_cnt > 0)
+
+// Defines the zervice zervice_name serving the requests declared for decl_name. The state of the
+// zervice is only guarded by its reader/writer lock if it is shared by several threads.
+#define __ZERV_INSTANCE_DEF(zervice_name, decl_name, heap_size, enqueue_hook, zervice_executor,    \
+			    zervice_cmd_locks, zervice_msg_locks, zervice_shards, initialized,     \
+			    shared)                                                                \
+	extern const zervice_t zervice_name;                                                       \
+	STRUCT_SECTION_ITERABLE(zerv_init, __##zervice_name##_boot) = {                            \
+		.serv = &zervice_name,                                                             \
+		.done = ATOMIC_INIT(initialized),                                                  \
+	};                                                                                         \
 	static K_HEAP_DEFINE(__##zervice_name##_heap, heap_size);                                  \
 	static K_FIFO_DEFINE(__##zervice_name##_fifo);                                             \
 	static K_MUTEX_DEFINE(__##zervice_name##_mtx);                                             \
+	static K_MUTEX_DEFINE(__##zervice_name##_wmtx);                                            \
+	static K_CONDVAR_DEFINE(__##zervice_name##_cond);                                          \
+	COND_CODE_1(CONFIG_ZERV_PRIO_INHERIT, (static zerv_prio_t __##zervice_name##_prio;), ())   \
+	static zerv_rwlock_t __##zervice_name##_rwlock = {                                         \
+		.state = ATOMIC_INIT(0),                                                           \
+		.mtx = &__##zervice_name##_mtx,                                                    \
+		.cond = &__##zervice_name##_cond,                                                  \
+		.wmtx = &__##zervice_name##_wmtx,                                                  \
+	};                                                                                         \
 	const zervice_t zervice_name __aligned(4) = {                                              \
 		.name = #zervice_name,                                                             \
 		.heap = &__##zervice_name##_heap,                                                  \
 		.fifo = &__##zervice_name##_fifo,                                                  \
 		.mtx = &__##zervice_name##_mtx,                                                    \
-		.cmd_instance_cnt = __##zervice_name##_cmd_cnt,                                    \
-		.cmd_instances = zervice_name##_cmd_instances,                                     \
-		.msg_instance_cnt = __##zervice_name##_msg_cnt,                                    \
-		.msg_instances = zervice_name##_msg_instances,                                     \
+		.rwlock = (shared) ? &__##zervice_name##_rwlock : NULL,                            \
+		.cmd_instance_cnt = __##decl_name##_cmd_cnt,                                       \
+		.cmd_instances = decl_name##_cmd_instances,                                        \
+		.msg_instance_cnt = __##decl_name##_msg_cnt,                                       \
+		.msg_instances = decl_name##_msg_instances,                                        \
 		.topic_subscribers_cnt =                                                           \
-			__##zervice_name##_topic_msg_cnt - __ZERV_TOPIC_MSG_ID_OFFSET - 1,         \
-		.topic_subscriber_instances = zervice_name##_topic_subscriber_instances,           \
-		.topic_subscriber_lists = zervice_name##_subscribed_topics,                        \
+			__##decl_name##_topic_msg_cnt - __ZERV_TOPIC_MSG_ID_OFFSET - 1,            \
+		.topic_subscriber_instances = decl_name##_topic_subscriber_instances,              \
+		.on_enqueue = enqueue_hook,                                                        \
+		.executor = zervice_executor,                                                      \
+		.cmd_locks = zervice_cmd_locks,                                                    \
+		.msg_locks = zervice_msg_locks,                                                    \
+		.shard_set = zervice_shards,                                                       \
+		.prio = COND_CODE_1(CONFIG_ZERV_PRIO_INHERIT, (&__##zervice_name##_prio), (NULL)), \
+		.init = &__##zervice_name##_boot,                                                  \
 	};
 
 /**
@@ -109,7 +197,79 @@
  * must be declared before the zervice thread.
  */
 #define ZERV_DEF_THREAD(zervice, heap_size, stack_size, prio, on_init_cb, zerv_events...)          \
-	ZERV_DEF(zervice, heap_size);                                                              \
+	__ZERV_DEF_THREAD(zervice, heap_size, stack_size, prio, 0, on_init_cb, zerv_events)
+
+/**
+ * @brief Macro for defining a zervice that is handled on a thread like ZERV_DEF_THREAD, with the
+ * thread only started when the first request is queued to the zervice.
+ *
+ * The first command, message or topic event sent to the zervice starts the thread, which calls
+ * on_init_cb and then handles the requests queued meanwhile in order. A zervice that is never
+ * used never runs its thread or on_init_cb, which keeps them out of the boot time.
+ *
+ * @param zervice The name of the zervice. This should be the same name as declared with the
+ * ZERV_DECL macro.
+ * @param heap_size The size of the heap of the zervice. It must hold the requests queued while
+ * the zervice is initialized.
+ * @param stack_size The size of the stack of the zervice thread.
+ * @param prio The priority of the zervice thread.
+ * @param on_init_cb The callback function that is called when the zervice thread is started.
+ * @param zerv_events... The events of the zervice, provided as a list of event names. The events
+ * are only waited on once the thread has been started.
+ *
+ * @note The stack of the thread is still allocated statically. The thread is created by the first
+ * request, which may be sent before the static threads exist, such as from a SYS_INIT, but not
+ * from an ISR.
+ */
+#define ZERV_DEF_THREAD_LAZY(zervice, heap_size, stack_size, prio, on_init_cb, zerv_events...)     \
+	static zerv_lazy_t __##zervice##_lazy;                                                     \
+	__ZERV_DEF(zervice, heap_size, zerv_internal_lazy_start, &__##zervice##_lazy, 0);          \
+	__ZERV_EVENTS_DEF(zervice, zerv_events);                                                   \
+	static K_THREAD_STACK_DEFINE(__##zervice##_stack, stack_size);                             \
+	static struct k_thread __##zervice##_thread_data;                                          \
+	static zerv_lazy_t __##zervice##_lazy = {                                                  \
+		.started = ATOMIC_INIT(0),                                                         \
+		.thread = &__##zervice##_thread_data,                                              \
+		.stack = __##zervice##_stack,                                                      \
+		.stack_bytes = K_THREAD_STACK_SIZEOF(__##zervice##_stack),                         \
+		.thread_prio = prio,                                                               \
+		.events = &__##zervice##_events_arg,                                               \
+		.init_cb = on_init_cb,                                                             \
+	}
+
+/**
+ * @brief Macro for defining a zervice that is handled on a thread like ZERV_DEF_THREAD, with the
+ * thread placed on a set of CPUs.
+ *
+ * @param zervice The name of the zervice. This should be the same name as declared with the
+ * ZERV_DECL macro.
+ * @param heap_size The size of the heap of the zervice.
+ * @param stack_size The size of the stack of the zervice thread.
+ * @param prio The priority of the zervice thread.
+ * @param placement The CPUs to run the zervice thread on, given with ZERV_PLACE_CPUS,
+ * ZERV_PLACE_GROUP or ZERV_PLACE_RT.
+ * @param on_init_cb The callback function that is called when the zervice thread is started.
+ * @param zerv_events... The events of the zervice, provided as a list of event names.
+ *
+ * @note Requires CONFIG_ZERV_PLACEMENT. The thread is started once it has been placed, after all
+ * static threads have been created.
+ */
+#define ZERV_DEF_THREAD_PLACED(zervice, heap_size, stack_size, prio, placement, on_init_cb,        \
+			       zerv_events...)                                                     \
+	__ZERV_DEF_THREAD(zervice, heap_size, stack_size, prio, SYS_FOREVER_MS, on_init_cb,        \
+			  zerv_events);                                                            \
+	__ZERV_PLACEMENT_DEF(zervice, placement)
+
+#define __ZERV_DEF_THREAD(zervice, heap_size, stack_size, prio, delay, on_init_cb, zerv_events...) \
+	__ZERV_DEF(zervice, heap_size, NULL, NULL, 0);                                             \
+	__ZERV_THREAD_DEF(zervice, stack_size, prio, delay, on_init_cb, zerv_events)
+
+#define __ZERV_THREAD_DEF(zervice, stack_size, prio, delay, on_init_cb, zerv_events...)            \
+	__ZERV_EVENTS_DEF(zervice, zerv_events);                                                   \
+	static K_THREAD_DEFINE(__##zervice##_thread, stack_size, (k_thread_entry_t)__zerv_thread,  \
+			       &zervice, &__##zervice##_events_arg, on_init_cb, prio, 0, delay)
+
+#define __ZERV_EVENTS_DEF(zervice, zerv_events...)                                                 \
 	static const struct k_poll_event __##zervice##_k_poll_event =                              \
 		K_POLL_EVENT_STATIC_INITIALIZER(K_POLL_TYPE_FIFO_DATA_AVAILABLE,                   \
 						K_POLL_MODE_NOTIFY_ONLY, &__##zervice##_fifo, 0);  \
@@ -121,9 +281,84 @@
 	static zerv_events_t __##zervice##_events_arg = {                                          \
 		.events = __##zervice##_events,                                                    \
 		.event_cnt = ARRAY_SIZE(__##zervice##_events),                                     \
+	}
+
+/**
+ * @brief Macro for defining a zervice that is handled by several worker threads sharing its
+ * request queue.
+ *
+ * The calls to parallel commands, declared with ZERV_CMD_DECL_PARALLEL, are handled by the
+ * workers at the same time. All other requests are exclusive and handled by one worker at a time,
+ * in the order they were queued.
+ *
+ * @param zervice The name of the zervice. This should be the same name as declared with the
+ * ZERV_DECL macro.
+ * @param heap_size The size of the heap of the zervice. It must hold the requests of all workers.
+ * @param stack_size The size of the stack of each worker thread.
+ * @param prio The priority of the worker threads.
+ * @param workers The number of worker threads, as an integer literal.
+ * @param on_init_cb The callback function that is called by the first worker before any request
+ * is handled.
+ *
+ * @note A replicated zervice can not wait on events.
+ */
+#define ZERV_DEF_REPLICATED(zervice, heap_size, stack_size, prio, workers, on_init_cb)             \
+	__ZERV_INSTANCE_DEF(zervice, zervice, heap_size, NULL, NULL, NULL, NULL, NULL, 0, 1);      \
+	static K_MUTEX_DEFINE(__##zervice##_dispatch);                                             \
+	static K_SEM_DEFINE(__##zervice##_ready, 0, workers);                                      \
+	static zerv_replicas_t __##zervice##_replicas = {                                          \
+		.dispatch = &__##zervice##_dispatch,                                               \
+		.ready = &__##zervice##_ready,                                                     \
+		.worker_cnt = workers,                                                             \
+		.init_cb = on_init_cb,                                                             \
 	};                                                                                         \
-	static K_THREAD_DEFINE(__##zervice##_thread, stack_size, (k_thread_entry_t)__zerv_thread,  \
-			       &zervice, &__##zervice##_events_arg, on_init_cb, prio, 0, 0)
+	LISTIFY(workers, __ZERV_REPLICA_THREAD_DEF, (;), zervice, stack_size, prio)
+
+/**
+ * @brief Macro for defining a zervice that is partitioned into shards, each with a heap, a request
+ * queue and a thread of its own.
+ *
+ * The clients call the zervice by its name, and every request is routed to one of the shards by
+ * a key taken from the parameters of the request. The requests with the same key always go to the
+ * same shard, which should own the state of that key. A handler finds the shard it runs on with
+ * zerv_shard_index.
+ *
+ * @param zervice The name of the zervice. This should be the same name as declared with the
+ * ZERV_DECL macro.
+ * @param heap_size The size of the heap of each shard.
+ * @param stack_size The size of the stack of each shard thread.
+ * @param prio The priority of the shard threads.
+ * @param shards The number of shards, as an integer literal.
+ * @param key_fn The function returning the key of a request, given the parameters of the
+ * request. It is called on the thread of the client for every command and message.
+ * @param on_init_cb The callback function that is called by each shard thread when it is started.
+ *
+ * @note With CONFIG_ZERV_PLACEMENT shard n is pinned to CPU n modulo the number of CPUs. A
+ * sharded zervice can not subscribe to topics or wait on events, and its command handlers can not
+ * await other zervices.
+ */
+#define ZERV_DEF_SHARDED(zervice, heap_size, stack_size, prio, shards, key_fn, on_init_cb)         \
+	BUILD_ASSERT(__##zervice##_topic_msg_cnt == __ZERV_TOPIC_MSG_ID_OFFSET + 1,                \
+		     "A sharded zervice can not subscribe to topics");                             \
+	LISTIFY(shards, __ZERV_SHARD_DEF, (;), zervice, heap_size, stack_size, prio, on_init_cb);  \
+	static const zervice_t *const __##zervice##_shard_instances[] = {                          \
+		LISTIFY(shards, __ZERV_SHARD_POINTER, (, ), zervice)};                             \
+	static const k_tid_t *const __##zervice##_shard_tids[] = {                                 \
+		LISTIFY(shards, __ZERV_SHARD_TID, (, ), zervice)};                                 \
+	static const zerv_shards_t __##zervice##_shards = {                                        \
+		.instances = __##zervice##_shard_instances,                                        \
+		.tids = __##zervice##_shard_tids,                                                  \
+		.instance_cnt = shards,                                                            \
+		.get_key = key_fn,                                                                 \
+	};                                                                                         \
+	const zervice_t zervice __aligned(4) = {                                                   \
+		.name = #zervice,                                                                  \
+		.cmd_instance_cnt = __##zervice##_cmd_cnt,                                         \
+		.cmd_instances = zervice##_cmd_instances,                                          \
+		.msg_instance_cnt = __##zervice##_msg_cnt,                                         \
+		.msg_instances = zervice##_msg_instances,                                          \
+		.shard_set = &__##zervice##_shards,                                                \
+	}
 
 /**
  * @brief Macro for defining a zervice that is handled on a thread that processes requests and
@@ -146,6 +381,35 @@
  */
 #define ZERV_DEF_PERIODIC_THREAD(zervice, heap_size, stack_size, prio, period, on_init_cb,         \
 				 periodic_cb, events...)                                           \
+	__ZERV_DEF_PERIODIC_THREAD(zervice, heap_size, stack_size, prio, 0, period, on_init_cb,    \
+				   periodic_cb, events)
+
+/**
+ * @brief Macro for defining a zervice like ZERV_DEF_PERIODIC_THREAD, with the thread placed on a
+ * set of CPUs.
+ *
+ * @param zervice The name of the zervice. This should be the same name as declared with the
+ * ZERV_DECL macro.
+ * @param heap_size The size of the heap of the zervice.
+ * @param stack_size The size of the stack of the zervice thread.
+ * @param prio The priority of the zervice thread.
+ * @param placement The CPUs to run the zervice thread on, given with ZERV_PLACE_CPUS,
+ * ZERV_PLACE_GROUP or ZERV_PLACE_RT.
+ * @param period The period of the periodic callback.
+ * @param on_init_cb The callback function that is called when the zervice thread is started.
+ * @param periodic_cb The callback function that is called periodically.
+ * @param events... The events of the zervice, provided as a list of event names.
+ *
+ * @note Requires CONFIG_ZERV_PLACEMENT.
+ */
+#define ZERV_DEF_PERIODIC_THREAD_PLACED(zervice, heap_size, stack_size, prio, placement, period,   \
+					on_init_cb, periodic_cb, events...)                        \
+	__ZERV_DEF_PERIODIC_THREAD(zervice, heap_size, stack_size, prio, SYS_FOREVER_MS, period,   \
+				   on_init_cb, periodic_cb, events);                               \
+	__ZERV_PLACEMENT_DEF(zervice, placement)
+
+#define __ZERV_DEF_PERIODIC_THREAD(zervice, heap_size, stack_size, prio, delay, period,            \
+				   on_init_cb, periodic_cb, events...)                             \
 	static K_SEM_DEFINE(__##zervice##_sem, 0, 1);                                              \
 	static void __##zervice##_periodic_timer_expired(struct k_timer *dummy)                    \
 	{                                                                                          \
@@ -171,8 +435,65 @@
 		k_timer_start(&__##zervice##_timer, period, period);                               \
 		return rc;                                                                         \
 	}                                                                                          \
-	ZERV_DEF_THREAD(zervice, heap_size, stack_size, prio, __##zervice##_init,                  \
-			__##zervice##_event, events)
+	__ZERV_DEF_THREAD(zervice, heap_size, stack_size, prio, delay, __##zervice##_init,         \
+			  __##zervice##_event, events)
+
+/*=================================================================================================
+ * ZERV INIT MACROS
+ *===============================================================================================*/
+
+/**
+ * @brief Macro for declaring the zervices that must be initialized before a zervice is.
+ *
+ * The on_init_cb of the zervice is called once the on_init_cb of every prerequisite has
+ * returned, so it may call the prerequisites right away. The zervices without prerequisites are
+ * initialized at the same time on their own threads, and each zervice waiting for prerequisites
+ * goes on as soon as the last of them is initialized.
+ *
+ * @param zervice The name of the zervice.
+ * @param prerequisites... The names of the zervices to initialize first.
+ *
+ * @note The prerequisites must not depend on the zervice, directly or through other zervices.
+ * A lazy prerequisite is started by the zervice waiting for it. A pooled zervice does not hold a
+ * worker of the pool while it waits, so pooled zervices may depend on each other. Every shard of
+ * a sharded zervice waits for the prerequisites of the sharded zervice.
+ */
+#define ZERV_INIT_AFTER(zervice, prerequisites...)                                                 \
+	static const zervice_t *const __##zervice##_prerequisites[] = {                            \
+		FOR_EACH(__ZERV_INIT_PREREQUISITE_POINTER, (, ), prerequisites)};                  \
+	const STRUCT_SECTION_ITERABLE(zerv_init_after, __##zervice##_init_after) = {               \
+		.serv = &zervice,                                                                  \
+		.after = __##zervice##_prerequisites,                                              \
+		.after_cnt = ARRAY_SIZE(__##zervice##_prerequisites),                              \
+	}
+
+/*=================================================================================================
+ * ZERV PLACEMENT MACROS
+ *===============================================================================================*/
+
+/**
+ * @brief Placement of a zervice thread on the CPUs of a mask, where bit n stands for CPU n.
+ *
+ * @param cpu_mask The mask of CPUs.
+ */
+#define ZERV_PLACE_CPUS(cpu_mask) ((uint32_t)(cpu_mask) & (__ZERV_PLACEMENT_RT - 1))
+
+/**
+ * @brief Placement of zervice threads that talk heavily to each other on one CPU, so that the
+ * requests passed between them stay in the cache of that CPU.
+ *
+ * The zervices of a group share one CPU, and the groups are spread over the CPUs except
+ * CONFIG_ZERV_RT_CPU.
+ *
+ * @param group The index of the group.
+ */
+#define ZERV_PLACE_GROUP(group) (__ZERV_PLACEMENT_GROUP | (uint32_t)(group))
+
+/**
+ * @brief Placement of a real-time zervice thread on CONFIG_ZERV_RT_CPU, which is kept free of the
+ * zervice threads placed with ZERV_PLACE_GROUP.
+ */
+#define ZERV_PLACE_RT __ZERV_PLACEMENT_RT
 
 /*=================================================================================================
  * ZERV EVENT MACROS
@@ -237,4 +558,31 @@ zerv_request_t *zerv_get_pending_request(const zervice_t *serv, k_timeout_t time
  */
 zerv_rc_t zerv_handle_request(const zervice_t *serv, zerv_request_t *req);
 
+/**
+ * @brief Used from a handler of a sharded zervice to find the shard it is running on.
+ *
+ * @param[in] serv The sharded zervice.
+ *
+ * @return The index of the shard running on the calling thread, or -1 if the calling thread is not
+ * one of the shards of the zervice.
+ */
+int zerv_shard_index(const zervice_t *serv);
+
+/**
+ * @brief Wait for all zervices to be initialized, except the lazy zervices that have not been
+ * started.
+ *
+ * @param[in] timeout The longest time to wait.
+ *
+ * @return ZERV_RC_OK if all zervices are initialized, ZERV_RC_ERROR if the initialization of a
+ * zervice failed and ZERV_RC_TIMEOUT if the zervices were not initialized in time.
+ */
+zerv_rc_t zerv_wait_ready(k_timeout_t timeout);
+
+/**
+ * @brief Log the boot timeline, with the time each zervice waited for its prerequisites and the
+ * time its on_init_cb ran, relative to the start of the kernel.
+ */
+void zerv_boot_report(void);
+
 #endif // _ZERV_H_
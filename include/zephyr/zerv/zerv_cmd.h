@@ -72,6 +72,64 @@
 	typedef struct name##_ret {                                                                \
 		out                                                                                \
 	} name##_ret_t;                                                                            \
+	enum {                                                                                     \
+		__##name##_kind = ZERV_CMD_KIND_MUTATING                                           \
+	};                                                                                         \
+	extern zerv_cmd_inst_t __##name
+
+/**
+ * @brief Macro for declaring a read-only zervice command in a header file.
+ *
+ * A const command only reads the state of the zervice and never changes it. Instead of being
+ * queued to the zervice, its handler is called directly on the calling thread, so the call costs
+ * no heap allocation, no copy through the fifo and no context switch. Const commands run
+ * concurrently with each other and are only excluded against the handlers of the zervice that
+ * may mutate its state: the other commands, the messages, the topics and the events.
+ *
+ * @param name The name of the command.
+ * @param in The input parameters of the command. Should be declared with the ZERV_IN macro.
+ * @param out The output parameters of the command. Should be declared with the ZERV_OUT macro.
+ *
+ * @note The command is defined with the ZERV_CMD_HANDLER_DEF macro like any other command. The
+ * 	 handler must not change the state of the zervice and must not call the zervice itself.
+ */
+#define ZERV_CMD_DECL_CONST(name, in, out)                                                         \
+	typedef struct name##_param {                                                              \
+		in                                                                                 \
+	} name##_param_t;                                                                          \
+	typedef struct name##_ret {                                                                \
+		out                                                                                \
+	} name##_ret_t;                                                                            \
+	enum {                                                                                     \
+		__##name##_kind = ZERV_CMD_KIND_CONST                                              \
+	};                                                                                         \
+	extern zerv_cmd_inst_t __##name
+
+/**
+ * @brief Macro for declaring a parallel zervice command in a header file.
+ *
+ * A parallel command only touches state of its own, like a CRC over a flash region or a buffer
+ * to compress, and may be handled for any number of callers at once. On a zervice defined with
+ * ZERV_DEF_REPLICATED the calls are spread over the worker threads of the zervice. The other
+ * commands, the messages and the topics stay exclusive: they wait for the parallel calls queued
+ * before them, and hold back the calls queued after them.
+ *
+ * @param name The name of the command.
+ * @param in The input parameters of the command. Should be declared with the ZERV_IN macro.
+ * @param out The output parameters of the command. Should be declared with the ZERV_OUT macro.
+ *
+ * @note The command is defined with the ZERV_CMD_HANDLER_DEF macro like any other command.
+ */
+#define ZERV_CMD_DECL_PARALLEL(name, in, out)                                                      \
+	typedef struct name##_param {                                                              \
+		in                                                                                 \
+	} name##_param_t;                                                                          \
+	typedef struct name##_ret {                                                                \
+		out                                                                                \
+	} name##_ret_t;                                                                            \
+	enum {                                                                                     \
+		__##name##_kind = ZERV_CMD_KIND_PARALLEL                                           \
+	};                                                                                         \
 	extern zerv_cmd_inst_t __##name
 
 /**
@@ -91,9 +149,87 @@
 		.id = __##cmd_name##_id,                                                           \
 		.is_locked = ATOMIC_INIT(false),                                                   \
 		.handler = (zerv_cmd_abstract_handler_t)__##cmd_name##_handler,                    \
+		.kind = (zerv_cmd_kind_t)__##cmd_name##_kind,                                      \
 	};                                                                                         \
 	zerv_rc_t __##cmd_name##_handler(const cmd_name##_param_t *in, cmd_name##_ret_t *out)
 
+/**
+ * @brief Macro for defining a zervice command handler that can await calls to other zervices.
+ *
+ * The handler is a stackless continuation. Between ZERV_ASYNC_BEGIN and ZERV_ASYNC_END it may
+ * await calls with ZERV_AWAIT_CALL. An await returns from the handler to the zervice, which goes
+ * on handling its other requests and events meanwhile. Once the response has arrived the handler
+ * is called again and resumes right after the await. The caller of the command is answered when
+ * the handler completes. As the zervice is free while the handler awaits, calls from the awaited
+ * zervice back to this zervice do not deadlock.
+ *
+ * @param cmd_name The name of the request.
+ * @param in Pointer to the input parameters of the request, valid across the awaits.
+ * @param out Pointer to the output parameters of the request, valid across the awaits.
+ *
+ * @note Local variables lose their values at an await, state needed after it must be kept in
+ * 	 static variables. The body can not use switch statements around an await, and only one
+ * 	 await is allowed per line.
+ */
+#define ZERV_CMD_ASYNC_HANDLER_DEF(cmd_name, in, out)                                              \
+	BUILD_ASSERT((int)__##cmd_name##_kind == (int)ZERV_CMD_KIND_MUTATING,                      \
+		     "A const command can not await");                                             \
+	zerv_rc_t __##cmd_name##_handler(const cmd_name##_param_t *in, cmd_name##_ret_t *out,      \
+					 zerv_async_t *__zerv_async);                              \
+	static zerv_async_t __##cmd_name##_async = {.cmd = &__##cmd_name};                         \
+	zerv_cmd_inst_t __##cmd_name __aligned(4) = {                                              \
+		.name = #cmd_name,                                                                 \
+		.id = __##cmd_name##_id,                                                           \
+		.is_locked = ATOMIC_INIT(false),                                                   \
+		.handler = NULL,                                                                   \
+		.kind = (zerv_cmd_kind_t)__##cmd_name##_kind,                                      \
+		.async_handler = (zerv_cmd_async_abstract_handler_t)__##cmd_name##_handler,        \
+		.async = &__##cmd_name##_async,                                                    \
+	};                                                                                         \
+	zerv_rc_t __##cmd_name##_handler(const cmd_name##_param_t *in, cmd_name##_ret_t *out,      \
+					 zerv_async_t *__zerv_async)
+
+/**
+ * @brief Macro for starting the body of a handler defined with ZERV_CMD_ASYNC_HANDLER_DEF.
+ */
+#define ZERV_ASYNC_BEGIN()                                                                         \
+	switch (__zerv_async->lc) {                                                                \
+	case 0:
+
+/**
+ * @brief Macro for ending the body of a handler defined with ZERV_CMD_ASYNC_HANDLER_DEF.
+ *
+ * @param rc The return code passed to the caller of the command.
+ */
+#define ZERV_ASYNC_END(rc)                                                                         \
+	}                                                                                          \
+	return (rc)
+
+/**
+ * @brief Macro for calling a zervice from a handler defined with ZERV_CMD_ASYNC_HANDLER_DEF and
+ * resuming the handler once the response has arrived.
+ *
+ * @param zervice The name of the zervice to call.
+ * @param cmd The name of the command to call.
+ * @param[out] retcode The variable to store the return code of the call in, assigned after the
+ * await.
+ * @param[out] p_ret Pointer to where the response is stored. It must outlive the await, like a
+ * static variable.
+ * @param[in] params... The arguments to the command.
+ */
+#define ZERV_AWAIT_CALL(zervice, cmd, retcode, p_ret, params...)                                   \
+	do {                                                                                       \
+		__zerv_async->lc = __LINE__;                                                       \
+		__zerv_async->rc = zerv_internal_async_call(                                       \
+			__zerv_async, &zervice, &__##cmd, sizeof(cmd##_param_t),                   \
+			&(cmd##_param_t){params}, (cmd##_ret_t *){p_ret}, sizeof(cmd##_ret_t));    \
+		if (__zerv_async->rc == ZERV_RC_FUTURE) {                                          \
+			return ZERV_RC_FUTURE;                                                     \
+		}                                                                                  \
+	case __LINE__:                                                                             \
+		retcode = __zerv_async->rc;                                                        \
+	} while (0)
+
 /*=================================================================================================
  * ZERVICE CMD CLIENT MACROS
  *===============================================================================================*/
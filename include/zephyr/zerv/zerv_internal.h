@@ -25,6 +25,7 @@
 #include <zephyr/sys/atomic.h>
 #include <zephyr/sys/util_macro.h>
 #include <zephyr/sys/slist.h>
+#include <zephyr/sys/iterable_sections.h>
 
 /*=================================================================================================
  * DECLARATIONS
@@ -36,7 +37,8 @@ typedef enum {
 	ZERV_RC_ERROR = -EFAULT,
 	ZERV_RC_TIMEOUT = -EAGAIN,
 	ZERV_RC_LOCKED = -EBUSY,
-	ZERV_RC_OK = 0
+	ZERV_RC_OK = 0,
+	ZERV_RC_FUTURE = 1, // The handler awaits a call and is resumed with its response.
 } zerv_rc_t;
 
 static inline const char *zerv_rc_to_str(zerv_rc_t rc)
@@ -54,14 +56,21 @@ static inline const char *zerv_rc_to_str(zerv_rc_t rc)
 		return "ZERV_RC_LOCKED";
 	case ZERV_RC_OK:
 		return "ZERV_RC_OK";
+	case ZERV_RC_FUTURE:
+		return "ZERV_RC_FUTURE";
 	default:
 		return "UNKNOWN";
 	}
 }
 
+struct zerv_async;
+
 typedef zerv_rc_t (*zerv_cmd_abstract_handler_t)(const void *req, void *resp);
+typedef zerv_rc_t (*zerv_cmd_async_abstract_handler_t)(const void *req, void *resp,
+						      struct zerv_async *async);
 typedef void (*zerv_msg_abstract_handler_t)(const void *params);
 typedef void (*zerv_raw_msg_abstract_handler_t)(size_t size, const void *data);
+typedef void (*zerv_topic_batch_abstract_handler_t)(const void *samples, size_t cnt);
 
 /**
  * @brief Used internally to store the parameters to a service request on the service's heap.
@@ -78,9 +87,21 @@ typedef struct {
 	size_t resp_len;
 	void *resp;
 	int rc; // Return code from the service request handler.
+	// The handler awaiting the response, NULL if the caller waits on response_sem.
+	struct zerv_async *async;
+	int prio; // The priority of the caller inherited by the zervice thread.
 	zerv_cmd_in_bytes_t client_req_params;
 } zerv_request_t;
 
+/**
+ * @brief The kinds of zervice commands.
+ */
+typedef enum {
+	ZERV_CMD_KIND_MUTATING = 0, // Handled on the zervice thread.
+	ZERV_CMD_KIND_CONST,        // Only reads the zervice state, handled on the calling thread.
+	ZERV_CMD_KIND_PARALLEL,     // Handled by any number of zervice threads at once.
+} zerv_cmd_kind_t;
+
 /**
  * @brief The type of a zervice command.
  * @note This is used internally to represent a zervice command.
@@ -90,8 +111,26 @@ typedef struct {
 	int id;
 	atomic_t is_locked;
 	zerv_cmd_abstract_handler_t handler;
+	zerv_cmd_kind_t kind;
+	zerv_cmd_async_abstract_handler_t async_handler; // NULL unless the handler can await.
+	struct zerv_async *async;
 } zerv_cmd_inst_t;
 
+/**
+ * @brief Used internally to let the const commands of a zervice run concurrently on the calling
+ * threads, excluded only against the handlers that may mutate the state of the zervice.
+ * @note A zervice has no lock unless it has const commands or is replicated, as its state is
+ * otherwise only entered by one thread at a time. Readers enter with a single atomic operation as
+ * long as no writer holds or waits for the lock, and only fall back to waiting on the condition
+ * variable while one does.
+ */
+typedef struct {
+	atomic_t state;          // The number of readers, plus the writer and waiter flags.
+	struct k_mutex *mtx;     // Protects the waiting on the condition variable.
+	struct k_condvar *cond;  // Signalled when the writer or the last reader leaves.
+	struct k_mutex *wmtx;    // Serializes the writers.
+} zerv_rwlock_t;
+
 /**
  * @brief The type of a zervice message.
  * @note This is used internally to represent a zervice message.
@@ -106,28 +145,219 @@ typedef struct {
 } zerv_msg_inst_t;
 
 struct zerv_topic_subscriber;
+
+/**
+ * @brief Used internally to keep the most recent events of a topic in a ring.
+ * @note The samples are stored back-to-back in one contiguous buffer of depth * sample_size bytes.
+ */
 typedef struct {
+	struct k_mutex *mtx;
+	uint8_t *samples;
+	size_t sample_size;
+	size_t depth;
+	size_t head; // Index of the slot that the next event is written to.
+	size_t cnt;  // Number of valid samples in the ring.
+} zerv_topic_history_t;
+
+/**
+ * @brief The type of a zervice topic.
+ * @note The subscriber table is resolved once at boot from the iterable section that collects
+ * all topic subscribers, sorted by topic. A topic defined as a pattern is never emitted on, its
+ * subscribers are instead reached through the match table of every topic whose path it matches.
+ */
+typedef struct zerv_topic {
+	const char *name;
+	const char *path; // Hierarchical path of the topic, or the pattern if is_pattern is set.
+	size_t sample_size;
+	bool is_pattern;
+	const struct zerv_topic_subscriber *subscribers;
+	size_t subscriber_cnt;
+	struct zerv_topic **matches; // The patterns that match the path of the topic.
+	size_t match_cnt;
+	zerv_topic_history_t *history; // NULL if the topic keeps no history.
+} zerv_topic_t;
+
+typedef struct zervice {
 	const char *name;
 	struct k_heap *heap;
 	struct k_fifo *fifo;
 	struct k_mutex *mtx;
+	zerv_rwlock_t *rwlock;
 	size_t cmd_instance_cnt;
 	zerv_cmd_inst_t **cmd_instances;
 	size_t msg_instance_cnt;
 	zerv_msg_inst_t **msg_instances;
 	size_t topic_subscribers_cnt;
-	struct zerv_topic_subscriber **topic_subscriber_instances;
-	sys_slist_t **topic_subscriber_lists;
+	const struct zerv_topic_subscriber *const *topic_subscriber_instances;
+	// Called after a request has been queued to the zervice, NULL if the zervice has a thread
+	// of its own waiting on the fifo.
+	void (*on_enqueue)(const struct zervice *serv);
+	void *executor; // The executor running the zervice, used by on_enqueue.
+	// The locks of the commands and messages of a shard, NULL to use the locks of the
+	// instances.
+	atomic_t *cmd_locks;
+	atomic_t *msg_locks;
+	const struct zerv_shards *shard_set; // Set if the zervice routes its requests to shards.
+	struct zerv_prio *prio; // NULL unless the zervice thread inherits the priority of callers.
+	struct zerv_init *init; // The initialization of the zervice, NULL for a sharded zervice.
 } zervice_t;
 
+/**
+ * @brief Used internally to keep track of the initialization of a zervice at boot.
+ * @note The records are collected in an iterable section, which is walked to wait for all
+ * zervices to be initialized and to report the boot timeline. The times are uptime ticks.
+ */
+typedef struct zerv_init {
+	const zervice_t *serv;
+	atomic_t done;      // Set once on_init_cb has returned, or from boot if there is none.
+	int rc;             // The return code of on_init_cb.
+	int64_t wait_start; // When the zervice started to wait for its prerequisites.
+	int64_t init_start; // When on_init_cb was called.
+	int64_t init_end;   // When on_init_cb returned.
+} zerv_init_t;
+
+/**
+ * @brief Used internally to declare the zervices that must be initialized before a zervice.
+ * @note The declarations are collected in an iterable section, which is searched by the zervice
+ * once before its initialization.
+ */
+typedef struct zerv_init_after {
+	const zervice_t *serv;
+	const zervice_t *const *after; // The prerequisites of the zervice.
+	size_t after_cnt;
+} zerv_init_after_t;
+
+// The number of thread priorities a caller of a zervice may have.
+#define __ZERV_PRIO_LEVELS (K_LOWEST_APPLICATION_THREAD_PRIO - K_HIGHEST_THREAD_PRIO + 1)
+
+/**
+ * @brief Used internally to let a zervice thread inherit the priority of its waiting callers.
+ * @note The callers are counted per priority, so the thread can drop to the priority of the
+ * highest caller still waiting once a request has been handled.
+ */
+typedef struct zerv_prio {
+	struct k_spinlock lock;
+	k_tid_t thread; // The zervice thread, NULL until it has been started.
+	int base;       // The priority of the zervice thread when no caller is waiting.
+	uint8_t callers[__ZERV_PRIO_LEVELS];
+} zerv_prio_t;
+
+/**
+ * @brief The type of the function picking the shard of a request from its parameters.
+ */
+typedef uint32_t (*zerv_shard_key_fn_t)(const void *params, size_t params_len);
+
+/**
+ * @brief Used internally to route the requests of a sharded zervice to its shards.
+ * @note The shards share the command and message instances of the sharded zervice, but each
+ * shard keeps its own locks of them.
+ */
+typedef struct zerv_shards {
+	const zervice_t *const *instances;
+	const k_tid_t *const *tids; // The threads of the shards, in the order of the instances.
+	size_t instance_cnt;
+	zerv_shard_key_fn_t get_key;
+} zerv_shards_t;
+
+/**
+ * @brief Used internally to keep the continuation of a command handler that awaits calls to
+ * other zervices.
+ * @note The command is locked while it is being handled, so each command needs a single
+ * continuation. The handler resumes at the line stored in lc once the response arrives.
+ */
+typedef struct zerv_async {
+	zerv_cmd_inst_t *cmd;
+	uint32_t lc;                  // The line to resume the handler at, 0 to start it over.
+	zerv_request_t *req;          // The request being handled, NULL while the command is idle.
+	const struct zervice *serv;   // The zervice handling the request.
+	const struct zervice *callee; // The zervice of the awaited call.
+	zerv_cmd_inst_t *callee_cmd;  // The awaited command.
+	void *resp;                   // Where the response of the awaited call is copied to.
+	zerv_rc_t rc;                 // The return code of the awaited call.
+} zerv_async_t;
+
+/**
+ * @brief Used internally to schedule a pooled zervice onto the shared worker threads.
+ * @note The actor is queued to the pool at most once at a time, and stays scheduled until the
+ * worker handling it is done. This is what keeps a zervice from running on two workers at once.
+ */
+typedef struct {
+	uint32_t unused; // Managed by the k_fifo.
+	const zervice_t *serv;
+	atomic_t scheduled;    // Set while the actor is queued to or handled by a worker.
+	atomic_t init_pending; // Set until init_cb has been called by a worker.
+	int (*init_cb)(void);
+} zerv_actor_t;
+
+/**
+ * @brief Used internally to run a zervice on a work queue.
+ * @note The work item is submitted on every request queued to the zervice. A work item that is
+ * already pending is not queued again, so one run of the handler may handle several requests.
+ */
+typedef struct {
+	struct k_work work;
+	struct k_work_q *workq; // NULL for the system work queue.
+	const zervice_t *serv;
+} zerv_work_t;
+
+/**
+ * @brief Used internally to create the thread of a lazy zervice once its first request is queued.
+ * @note The requests queued before the thread has initialized the zervice wait in the fifo. The
+ * thread is created rather than started, as the first request may be queued before the static
+ * threads have been created.
+ */
+typedef struct {
+	atomic_t started;
+	struct k_thread *thread;
+	k_thread_stack_t *stack;
+	size_t stack_bytes;
+	int thread_prio;
+	struct zerv_events *events;
+	int (*init_cb)(void);
+} zerv_lazy_t;
+
+/**
+ * @brief Used internally to place the thread of a zervice on its CPUs before the thread is
+ * started.
+ * @note The placements are collected in an iterable section, which is walked once by a start-up
+ * thread after all static threads have been created.
+ */
+typedef struct zerv_placement {
+	const zervice_t *serv;
+	const k_tid_t *tid;
+	uint32_t placement; // CPU mask, or a group or the real-time CPU if one of the flags is set.
+} zerv_placement_t;
+
+/**
+ * @brief The type of a state object owned by a zervice.
+ * @note The state is protected by a sequence lock. The sequence is odd while an update is being
+ * written, and a reader retries its copy until it saw the same even sequence before and after.
+ */
+typedef struct {
+	const char *name;
+	const zervice_t *owner;
+	struct k_spinlock *lock; // Serializes the writers, never taken by the readers.
+	atomic_t seq;
+	void *data;
+	size_t size;
+} zerv_state_t;
+
 typedef zerv_rc_t (*zerv_msg_function_t)(const zervice_t *serv, zerv_msg_inst_t *msg_instance,
 					 size_t client_msg_params_len,
 					 const void *client_msg_params);
 
+/**
+ * @brief The type of a zervice topic subscription.
+ * @note Subscriptions are placed in an iterable section named after the topic and the zervice,
+ * so the linker lays out the subscribers of each topic as one contiguous array.
+ */
 typedef struct zerv_topic_subscriber {
-	sys_snode_t node;
+	zerv_topic_t *topic;
 	zerv_msg_inst_t *msg_instance;
 	const zervice_t *serv;
+	// Handler receiving each queued block of events in one call, NULL if the events are passed
+	// one by one to the handler of the message instance.
+	zerv_topic_batch_abstract_handler_t batch_handler;
 } zerv_topic_subscriber_t;
 
 /**
@@ -139,11 +369,21 @@ typedef struct {
 	uint32_t type;
 } zerv_event_t;
 
-typedef struct {
+typedef struct zerv_events {
 	zerv_event_t **events;
 	size_t event_cnt;
 } zerv_events_t;
 
+/**
+ * @brief Used internally to let several threads handle the requests of one zervice.
+ */
+typedef struct {
+	struct k_mutex *dispatch; // Held by the replica taking the next request from the fifo.
+	struct k_sem *ready;      // Given to the other replicas once the zervice is initialized.
+	size_t worker_cnt;
+	int (*init_cb)(void);
+} zerv_replicas_t;
+
 /**
  * @brief DONT TOUCH, USED INTERNALLY to call a service request from the client thread.
  *
@@ -177,12 +417,198 @@ zerv_rc_t zerv_internal_client_message_handler(const zervice_t *serv, zerv_msg_i
 					       size_t client_msg_params_len,
 					       const void *client_msg_params);
 
-zerv_rc_t zerv_internal_emit_topic(sys_slist_t *subscribers, size_t params_size,
-				   const void *params);
+/**
+ * @brief DONT TOUCH, USED INTERNALLY to call a zervice from a command handler without waiting for
+ * the response.
+ *
+ * @param[in] async The continuation of the calling handler.
+ * @param[in] serv The zervice to call.
+ * @param[in] req_instance The command to call.
+ * @param[in] client_req_params_len The length of the request.
+ * @param[in] client_req_params The request parameters.
+ * @param[out] resp Where the response is copied to once it arrives.
+ * @param[in] resp_len The length of the response.
+ *
+ * @return ZERV_RC_FUTURE if the call was queued and the handler is to be resumed with the
+ * response, otherwise the return code of the call that is already done or failed.
+ */
+zerv_rc_t zerv_internal_async_call(zerv_async_t *async, const zervice_t *serv,
+				   zerv_cmd_inst_t *req_instance, size_t client_req_params_len,
+				   const void *client_req_params, void *resp, size_t resp_len);
+
+/**
+ * @brief DONT TOUCH, USED INTERNALLY to queue a request to a zervice and wake up the executor
+ * running it.
+ *
+ * @param[in] serv The zervice to queue the request to.
+ * @param[in] req The request, allocated on the heap of the zervice.
+ */
+void zerv_internal_enqueue(const zervice_t *serv, zerv_request_t *req);
+
+/**
+ * @brief DONT TOUCH, USED INTERNALLY to drop a request to a zervice that can not handle it. The
+ * caller of a command gets ZERV_RC_ERROR as the response.
+ *
+ * @param[in] serv The zervice the request was queued to.
+ * @param[in] request The request taken from the fifo of the zervice.
+ */
+void zerv_internal_reject_request(const zervice_t *serv, zerv_request_t *request);
+
+/**
+ * @brief DONT TOUCH, USED INTERNALLY to queue a pooled zervice to the shared worker threads, unless
+ * it already is queued or handled by one of them.
+ *
+ * @param[in] serv The pooled zervice.
+ */
+void zerv_internal_pool_schedule(const zervice_t *serv);
+
+/**
+ * @brief DONT TOUCH, USED INTERNALLY to queue the pooled zervices waiting for prerequisites to the
+ * shared worker threads again, once another zervice has been initialized.
+ */
+void zerv_internal_pool_wake(void);
+
+/**
+ * @brief DONT TOUCH, USED INTERNALLY to submit the work item of a work queue zervice.
+ *
+ * @param[in] serv The work queue zervice.
+ */
+void zerv_internal_workq_submit(const zervice_t *serv);
+
+/**
+ * @brief DONT TOUCH, USED INTERNALLY to initialize a zervice once its prerequisites are
+ * initialized, and to let the zervices waiting for it go on.
+ *
+ * @param[in] serv The zervice to initialize.
+ * @param[in] init_cb The initialization callback of the zervice, may be NULL.
+ *
+ * @return The return code of init_cb, 0 if there is none.
+ */
+int zerv_internal_init(const zervice_t *serv, int (*init_cb)(void));
+
+/**
+ * @brief DONT TOUCH, USED INTERNALLY to check if the prerequisites of a zervice are initialized,
+ * without waiting for them. The lazy prerequisites are started.
+ *
+ * @param[in] serv The zervice to initialize.
+ *
+ * @return true if zerv_internal_init would not wait for any prerequisite.
+ */
+bool zerv_internal_init_ready(const zervice_t *serv);
+
+/**
+ * @brief DONT TOUCH, USED INTERNALLY to start the thread of a lazy zervice, unless it already is
+ * started.
+ *
+ * @param[in] serv The lazy zervice.
+ */
+void zerv_internal_lazy_start(const zervice_t *serv);
+
+/**
+ * @brief DONT TOUCH, USED INTERNALLY to resolve the placement of a zervice thread to the mask of
+ * the CPUs it stands for on this target.
+ *
+ * @param[in] placement The placement given with ZERV_PLACE_CPUS, ZERV_PLACE_GROUP or ZERV_PLACE_RT.
+ *
+ * @return The mask of the CPUs to run the thread on.
+ */
+uint32_t zerv_internal_placement_resolve(uint32_t placement);
+
+/**
+ * @brief DONT TOUCH, USED INTERNALLY to handle the requests queued to a work queue zervice.
+ *
+ * @param[in] work The work item of the zervice.
+ */
+void zerv_internal_workq_handler(struct k_work *work);
+
+/**
+ * @brief DONT TOUCH, USED INTERNALLY to emit events to all subscribers of a topic.
+ *
+ * @param[in] topic The topic to emit on.
+ * @param[in] params_size The size of one event.
+ * @param[in] params The event parameters, cnt events stored back-to-back.
+ * @param[in] cnt The number of events, which are queued to each subscriber as one request.
+ *
+ * @return ZERV_RC_OK if the events were passed on to the subscribers.
+ */
+zerv_rc_t zerv_internal_emit_topic(const zerv_topic_t *topic, size_t params_size,
+				   const void *params, size_t cnt);
+
+/**
+ * @brief DONT TOUCH, USED INTERNALLY to queue events for the topic fan-out worker.
+ *
+ * @param[in] topic The topic to emit on.
+ * @param[in] params_size The size of one event.
+ * @param[in] params The event parameters, cnt events stored back-to-back.
+ * @param[in] cnt The number of events.
+ *
+ * @return ZERV_RC_OK if the events were queued, ZERV_RC_NOMEM if the fan-out heap is full.
+ */
+zerv_rc_t zerv_internal_emit_topic_deferred(const zerv_topic_t *topic, size_t params_size,
+					    const void *params, size_t cnt);
+
+/**
+ * @brief DONT TOUCH, USED INTERNALLY to replay the history of a topic to one of its subscribers.
+ *
+ * @param[in] topic The topic to replay.
+ * @param[in] subscriber The subscriber to replay the history to.
+ * @param[in] cnt The maximum number of events to replay, starting from the most recent.
+ *
+ * @return ZERV_RC_OK if the events were queued, ZERV_RC_NOMEM if the subscriber's heap could not
+ * hold them and ZERV_RC_ERROR if the topic keeps no history.
+ */
+zerv_rc_t zerv_internal_replay_topic(const zerv_topic_t *topic,
+				     const struct zerv_topic_subscriber *subscriber, size_t cnt);
+
+/**
+ * @brief DONT TOUCH, USED INTERNALLY to publish a new value of a state object.
+ *
+ * @param[in] state The state object.
+ * @param[in] value The new value, of the size of the state.
+ *
+ * @return ZERV_RC_OK on success, ZERV_RC_NULLPTR if an argument is NULL.
+ */
+zerv_rc_t zerv_internal_state_publish(zerv_state_t *state, const void *value);
+
+/**
+ * @brief DONT TOUCH, USED INTERNALLY to read a consistent snapshot of a state object.
+ *
+ * @param[in] state The state object.
+ * @param[out] value Storage of the size of the state.
+ *
+ * @return ZERV_RC_OK on success, ZERV_RC_NULLPTR if an argument is NULL.
+ */
+zerv_rc_t zerv_internal_state_read(zerv_state_t *state, void *value);
+
+/**
+ * @brief DONT TOUCH, USED INTERNALLY to enter the state of a zervice as a reader.
+ * @param[in] rwlock The lock of the zervice.
+ */
+void zerv_internal_read_lock(zerv_rwlock_t *rwlock);
+
+/**
+ * @brief DONT TOUCH, USED INTERNALLY to leave the state of a zervice as a reader.
+ * @param[in] rwlock The lock of the zervice.
+ */
+void zerv_internal_read_unlock(zerv_rwlock_t *rwlock);
+
+/**
+ * @brief DONT TOUCH, USED INTERNALLY to enter the state of a zervice as the only writer.
+ * @param[in] rwlock The lock of the zervice.
+ */
+void zerv_internal_write_lock(zerv_rwlock_t *rwlock);
+
+/**
+ * @brief DONT TOUCH, USED INTERNALLY to leave the state of a zervice as a writer.
+ * @param[in] rwlock The lock of the zervice.
+ */
+void zerv_internal_write_unlock(zerv_rwlock_t *rwlock);
 
 void __zerv_thread(const zervice_t *p_zervice, zerv_events_t *zervice_events,
 		   int (*on_init_cb)(void));
 
+void __zerv_replica_thread(const zervice_t *p_zervice, zerv_replicas_t *replicas, size_t index);
+
 /*=================================================================================================
  * PUBLIC MACROS
  *===============================================================================================*/
@@ -200,13 +626,93 @@ void __zerv_thread(const zervice_t *p_zervice, zerv_events_t *zervice_events,
 
 #define __ZERV_CMD_INSTANCE_POINTER(cmd_name) &__##cmd_name
 
+#define __ZERV_TOPIC_IDENTIFIER(topic_name) __##topic_name##_topic
+
+#define __ZERV_STATE_IDENTIFIER(state_name) __##state_name##_state
+
+#define __ZERV_REPLICA_THREAD_DEF(n, zervice_name, stack_size, prio)                               \
+	static K_THREAD_DEFINE(__##zervice_name##_replica_##n, stack_size,                         \
+			       (k_thread_entry_t)__zerv_replica_thread, &zervice_name,             \
+			       &__##zervice_name##_replicas, (void *)n, prio, 0, 0)
+
+#define __ZERV_SHARD_POINTER(n, zervice_name) &zervice_name##_shard_##n
+
+#define __ZERV_SHARD_TID(n, zervice_name) &__##zervice_name##_shard_##n##_thread
+
+// The shards are spread over the CPUs when the zervice threads can be placed.
+#define __ZERV_SHARD_DEF(n, zervice_name, heap_size, stack_size, prio, on_init_cb)                 \
+	static atomic_t __##zervice_name##_shard_##n##_cmd_locks[__##zervice_name##_cmd_cnt -      \
+								 __ZERV_CMD_ID_OFFSET];            \
+	static atomic_t __##zervice_name##_shard_##n##_msg_locks[__##zervice_name##_msg_cnt -      \
+								 __ZERV_MSG_ID_OFFSET];            \
+	__ZERV_INSTANCE_DEF(zervice_name##_shard_##n, zervice_name, heap_size, NULL, NULL,         \
+			    __##zervice_name##_shard_##n##_cmd_locks,                              \
+			    __##zervice_name##_shard_##n##_msg_locks, NULL, 0,                     \
+			    __##zervice_name##_const_cnt > 0)                                      \
+	__ZERV_THREAD_DEF(zervice_name##_shard_##n, stack_size, prio,                              \
+			  COND_CODE_1(CONFIG_ZERV_PLACEMENT, (SYS_FOREVER_MS), (0)), on_init_cb)   \
+	COND_CODE_1(CONFIG_ZERV_PLACEMENT,                                                         \
+		    (; __ZERV_PLACEMENT_DEF(zervice_name##_shard_##n,                              \
+					    ZERV_PLACE_CPUS(BIT((n) % CONFIG_MP_MAX_NUM_CPUS)))),  \
+		    ())
+
+// Set in the placement of a zervice thread that is placed with the other threads of its group.
+#define __ZERV_PLACEMENT_GROUP BIT(31)
+// Set in the placement of a zervice thread that is placed alone on the real-time CPU.
+#define __ZERV_PLACEMENT_RT BIT(30)
+
+#define __ZERV_PLACEMENT_DEF(zervice_name, zervice_placement)                                      \
+	BUILD_ASSERT(IS_ENABLED(CONFIG_ZERV_PLACEMENT),                                            \
+		     "Placed zervices require CONFIG_ZERV_PLACEMENT");                             \
+	const STRUCT_SECTION_ITERABLE(zerv_placement, __##zervice_name##_placement) = {            \
+		.serv = &zervice_name,                                                             \
+		.tid = &__##zervice_name##_thread,                                                 \
+		.placement = zervice_placement,                                                    \
+	}
+
+#define __ZERV_INIT_PREREQUISITE_POINTER(zervice_name) &zervice_name
+
+#define __ZERV_TOPIC_DEF(topic_name, topic_path, topic_is_pattern, topic_history)                  \
+	STRUCT_SECTION_ITERABLE(zerv_topic, __ZERV_TOPIC_IDENTIFIER(topic_name)) = {               \
+		.name = #topic_name,                                                               \
+		.path = topic_path,                                                                \
+		.sample_size = sizeof(topic_name##_zerv_topic_t),                                  \
+		.is_pattern = topic_is_pattern,                                                    \
+		.subscribers = NULL,                                                               \
+		.subscriber_cnt = 0,                                                               \
+		.matches = NULL,                                                                   \
+		.match_cnt = 0,                                                                    \
+		.history = topic_history,                                                          \
+	}
+
+// The topic name leads the identifier as the iterable section is sorted by name, which keeps the
+// subscribers of a topic adjacent to each other.
+#define __ZERV_TOPIC_SUBSCRIBER_IDENTIFIER(topic_name, zervice_name)                               \
+	__##topic_name##_topic_sub_##zervice_name
+
+#define __ZERV_TOPIC_SUBSCRIBER_DEF(zervice_name, topic_name, msg_handler, topic_batch_handler)    \
+	zerv_msg_inst_t __##zervice_name##_##topic_name##_msg __aligned(4) = {                     \
+		.name = #zervice_name "_" #topic_name "_subscriber",                               \
+		.id = __##zervice_name##_##topic_name##_id,                                        \
+		.is_locked = ATOMIC_INIT(false),                                                   \
+		.handler = (zerv_msg_abstract_handler_t)msg_handler,                               \
+		.is_raw = false,                                                                   \
+		.raw_handler = NULL};                                                              \
+	const STRUCT_SECTION_ITERABLE(zerv_topic_subscriber,                                       \
+				      __ZERV_TOPIC_SUBSCRIBER_IDENTIFIER(topic_name,               \
+									 zervice_name)) = {        \
+		.topic = &__ZERV_TOPIC_IDENTIFIER(topic_name),                                     \
+		.msg_instance = &__##zervice_name##_##topic_name##_msg,                            \
+		.serv = &zervice_name,                                                             \
+		.batch_handler = (zerv_topic_batch_abstract_handler_t)topic_batch_handler,         \
+	}
+
 #define __ZERV_TOPIC_MSG_INSTANCE_POINTER(topic_msg_name, zervice_name)                            \
-	&__##zervice_name##_##topic_msg_name
+	&__ZERV_TOPIC_SUBSCRIBER_IDENTIFIER(topic_msg_name, zervice_name)
 
 #define __ZERV_TOPIC_MSG_EXTERN(topic_msg_name, zervice_name)                                      \
-	extern zerv_topic_subscriber_t __##zervice_name##_##topic_msg_name
-
-#define __ZERV_SUBSCRIBED_TOPIC_POINTER(topic_name) &topic_name##_subscribers
+	extern const zerv_topic_subscriber_t __ZERV_TOPIC_SUBSCRIBER_IDENTIFIER(topic_msg_name,    \
+										 zervice_name)
 
 #define __ZERV_DEFINE_CMD_INSTANCE_LIST(zervice, ...)                                              \
 	__unused static zerv_cmd_inst_t *zervice##_cmd_instances[] = {                             \
@@ -229,9 +735,9 @@ void __zerv_thread(const zervice_t *p_zervice, zerv_events_t *zervice_events,
 
 #define __ZERV_DEFINE_TOPIC_MSG_INSTANCE_LIST(zervice, ...)                                        \
 	FOR_EACH_FIXED_NONEMPTY_TERM(__ZERV_TOPIC_MSG_EXTERN, (;), zervice, __VA_ARGS__);          \
-	__unused static zerv_topic_subscriber_t *zervice##_topic_subscriber_instances[] = {        \
-		FOR_EACH_FIXED_NONEMPTY_TERM(__ZERV_TOPIC_MSG_INSTANCE_POINTER, (), zervice,       \
-					     __VA_ARGS__)};
+	__unused static const zerv_topic_subscriber_t *const                                       \
+		zervice##_topic_subscriber_instances[] = {FOR_EACH_FIXED_NONEMPTY_TERM(            \
+			__ZERV_TOPIC_MSG_INSTANCE_POINTER, (, ), zervice, __VA_ARGS__)};
 
 #define __ZERV_GET_CMD_INPUT(cmd_name, zervice)                                                    \
 	static inline cmd_name##_param_t *zerv_get_##cmd_name##_params(void)                       \
@@ -240,10 +746,6 @@ void __zerv_thread(const zervice_t *p_zervice, zerv_events_t *zervice_events,
 			->client_req_params.data;                                                  \
 	}
 
-#define __ZERV_DEFINE_SUBSCRIBED_TOPICS_LIST(zervice, ...)                                         \
-	__unused static sys_slist_t *zervice##_subscribed_topics[] __aligned(4) = {                \
-		FOR_EACH_NONEMPTY_TERM(__ZERV_SUBSCRIBED_TOPIC_POINTER, (, ), __VA_ARGS__)};
-
 #define __ZERV_GET_CMD_INPUT_DEF(zervice, ...)                                                     \
 	FOR_EACH_FIXED_ARG(__ZERV_GET_CMD_INPUT, (), zervice, __VA_ARGS__)
 
@@ -258,6 +760,11 @@ void __zerv_thread(const zervice_t *p_zervice, zerv_events_t *zervice_events,
 		FOR_EACH_NONEMPTY_TERM(__ZERV_MSG_ID_DECL, (, ), messages) __##name##_msg_cnt      \
 	}
 
+// The id of a response handed back to the zervice awaiting it.
+#define __ZERV_RESPONSE_ID (-1)
+
+#define __ZERV_CMD_CONST_TERM(cmd_name) +((int)__##cmd_name##_kind == (int)ZERV_CMD_KIND_CONST)
+
 #define __ZERV_CMD_ID_OFFSET 10000
 #define __ZERV_CMD_LIST(name, commands...)                                                         \
 	__ZERV_DEFINE_CMD_INSTANCE_LIST(name, commands)                                            \
@@ -265,11 +772,15 @@ void __zerv_thread(const zervice_t *p_zervice, zerv_events_t *zervice_events,
 	{                                                                                          \
 		__##name##_CMD_ID_OFFSET = __ZERV_CMD_ID_OFFSET,                                   \
 		FOR_EACH_NONEMPTY_TERM(__ZERV_CMD_ID_DECL, (, ), commands) __##name##_cmd_cnt      \
+	};                                                                                         \
+	enum __##name##_const_cmds_e                                                               \
+	{                                                                                          \
+		__##name##_const_cnt =                                                             \
+			0 FOR_EACH_NONEMPTY_TERM(__ZERV_CMD_CONST_TERM, (), commands)              \
 	}
 
 #define __ZERV_TOPIC_MSG_ID_OFFSET 20000
 #define __ZERV_SUBSCRIBED_TOPICS_LIST(name, topics...)                                             \
-	__ZERV_DEFINE_SUBSCRIBED_TOPICS_LIST(name, topics)                                         \
 	__ZERV_DEFINE_TOPIC_MSG_INSTANCE_LIST(name, topics)                                        \
 	enum __##name##_topic_msgs_e                                                               \
 	{                                                                                          \
@@ -0,0 +1,94 @@
+/*=================================================================================================
+ *
+ *           ██████╗ ██╗████████╗███╗   ███╗ █████╗ ███╗   ██╗     █████╗ ██████╗
+ *           ██╔══██╗██║╚══██╔══╝████╗ ████║██╔══██╗████╗  ██║    ██╔══██╗██╔══██╗
+ *           ██████╔╝██║   ██║   ██╔████╔██║███████║██╔██╗ ██║    ███████║██████╔╝
+ *           ██╔══██╗██║   ██║   ██║╚██╔╝██║██╔══██║██║╚██╗██║    ██╔══██║██╔══██╗
+ *           ██████╔╝██║   ██║   ██║ ╚═╝ ██║██║  ██║██║ ╚████║    ██║  ██║██████╔╝
+ *           ╚═════╝ ╚═╝   ╚═╝   ╚═╝     ╚═╝╚═╝  ╚═╝╚═╝  ╚═══╝    ╚═╝  ╚═╝╚═════╝
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * Copyright (c) 2023 BitMan AB
+ * contact: albin@bitman.se
+ *===============================================================================================*/
+#ifndef _ZERV_STATE_H_
+#define _ZERV_STATE_H_
+
+/*=================================================================================================
+ * INCLUDES
+ *===============================================================================================*/
+#include <zephyr/zerv/zerv_internal.h>
+
+/*=================================================================================================
+ * ZERV STATE MACROS
+ *===============================================================================================*/
+
+/**
+ * @brief Macro for declaring a state object of a zervice in a header file.
+ *
+ * A state object holds a value that is owned and updated by a zervice, such as a mode or a set of
+ * calibration values, and that any thread can read without calling the zervice.
+ *
+ * @param name The name of the state.
+ * @param type The type of the state value.
+ *
+ * @note The state must be defined in a source file using the ZERV_STATE_DEF macro.
+ */
+#define ZERV_STATE_DECL(name, type)                                                                \
+	typedef type name##_zerv_state_t;                                                          \
+	extern zerv_state_t __ZERV_STATE_IDENTIFIER(name)
+
+/**
+ * @brief Macro for defining a state object of a zervice in a source file.
+ *
+ * The value starts out zeroed. Reading it never blocks, takes no lock and makes no allocation:
+ * the reader copies the value and retries if an update was written meanwhile. The owner
+ * publishes updates with ZERV_STATE_PUBLISH, which is never blocked by the readers either.
+ *
+ * @param zervice_name The name of the zervice owning the state.
+ * @param state_name The name of the state.
+ * @param type The type of the state value, the same as given to ZERV_STATE_DECL.
+ */
+#define ZERV_STATE_DEF(zervice_name, state_name, type)                                             \
+	BUILD_ASSERT(sizeof(type) == sizeof(state_name##_zerv_state_t),                            \
+		     "The type of the state does not match its declaration");                      \
+	static struct k_spinlock __##state_name##_state_lock;                                      \
+	static state_name##_zerv_state_t __##state_name##_state_data;                              \
+	zerv_state_t __ZERV_STATE_IDENTIFIER(state_name) = {                                       \
+		.name = #state_name,                                                               \
+		.owner = &zervice_name,                                                            \
+		.lock = &__##state_name##_state_lock,                                              \
+		.seq = ATOMIC_INIT(0),                                                             \
+		.data = &__##state_name##_state_data,                                              \
+		.size = sizeof(state_name##_zerv_state_t),                                         \
+	}
+
+/**
+ * @brief Macro for publishing a new value of a state object.
+ *
+ * @param name The name of the state.
+ * @param value Pointer to the new value.
+ *
+ * @return ZERV_RC_OK on success.
+ *
+ * @note Should be called by the zervice owning the state. The update is written with interrupts
+ * 	 locked for the time it takes to copy the value, so keep the state small.
+ */
+#define ZERV_STATE_PUBLISH(name, value)                                                            \
+	zerv_internal_state_publish(&__ZERV_STATE_IDENTIFIER(name),                                \
+				    (const name##_zerv_state_t *){value})
+
+/**
+ * @brief Macro for reading a consistent snapshot of a state object.
+ *
+ * @param name The name of the state.
+ * @param[out] value Pointer to the storage of the snapshot.
+ *
+ * @return ZERV_RC_OK on success.
+ *
+ * @note Can be called from any thread and from an ISR.
+ */
+#define ZERV_STATE_READ(name, value)                                                               \
+	zerv_internal_state_read(&__ZERV_STATE_IDENTIFIER(name), (name##_zerv_state_t *){value})
+
+#endif // _ZERV_STATE_H_
@@ -36,39 +36,114 @@
 	typedef struct {                                                                           \
 		FOR_EACH(__ZERV_IMPL_STRUCT_MEMBER, (), params)                                    \
 	} name##_zerv_topic_t;                                                                     \
-	extern sys_slist_t name##_subscribers;
+	extern zerv_topic_t __ZERV_TOPIC_IDENTIFIER(name);
 
 /**
  * @brief Macro for defining a zervice topic in a source file.
  *
- * @param name The name of the topic.
+ * @param topic_name The name of the topic, which is also used as its path.
+ *
+ * @note The subscribers of the topic are collected at link time, see ZERV_TOPIC_HANDLER.
  */
-#define ZERV_TOPIC_DEF(name) __unused sys_slist_t name##_subscribers = {NULL};
+#define ZERV_TOPIC_DEF(topic_name) __ZERV_TOPIC_DEF(topic_name, #topic_name, false, NULL)
 
 /**
- * @brief Macro for defining a zervice message handler function in a source file.
+ * @brief Macro for defining a zervice topic placed in the hierarchical topic namespace.
  *
- * @param msg_name The name of the message.
- * @param params The name of the parameters of the message.
+ * @param topic_name The name of the topic.
+ * @param topic_path The path of the topic, levels separated by '/', e.g. "sensors/imu/0/accel".
  *
- * @note The message handler function must be defined in the same source file as the zervice
- * 	 definition.
+ * @note The topic is delivered to the subscribers of every pattern matching its path, see
+ * 	 ZERV_TOPIC_PATTERN_DEF.
+ */
+#define ZERV_TOPIC_DEF_PATH(topic_name, topic_path)                                                \
+	__ZERV_TOPIC_DEF(topic_name, topic_path, false, NULL)
+
+/**
+ * @brief Macro for defining a wildcard subscription to the hierarchical topic namespace.
+ *
+ * A pattern is declared with ZERV_TOPIC_DECL and subscribed to with ZERV_SUBSCRIBED_TOPICS and
+ * ZERV_TOPIC_HANDLER just like a topic. A '+' level in the pattern matches exactly one level of a
+ * topic path and a trailing '#' level matches any number of remaining levels, e.g.
+ * "sensors/imu/+/accel" or "sensors/#".
+ *
+ * The patterns are matched against the topic paths once at boot, and every topic keeps the
+ * patterns it matches in a table. Emitting on a topic therefore only visits its own subscribers
+ * and the subscribers of the matching patterns, regardless of how many topics and patterns exist.
+ *
+ * @param pattern_name The name of the pattern.
+ * @param topic_pattern The pattern to match topic paths against.
+ *
+ * @note All topics matched by a pattern must have the same parameters as the pattern. Events can
+ * 	 not be emitted on a pattern.
+ */
+#define ZERV_TOPIC_PATTERN_DEF(pattern_name, topic_pattern)                                        \
+	__ZERV_TOPIC_DEF(pattern_name, topic_pattern, true, NULL)
+
+/**
+ * @brief Macro for defining a zervice topic that keeps its most recent events in a source file.
+ *
+ * The last history_depth events emitted on the topic are kept in a contiguous ring, so that a
+ * zervice that restarts or falls out of sync can get them again with ZERV_TOPIC_REPLAY.
+ *
+ * @param topic_name The name of the topic.
+ * @param history_depth The number of events to keep.
  */
-#define ZERV_TOPIC_HANDLER(zervice_name, topic, params)                                            \
-	__unused static void __##zervice_name##_##topic##_handler(                                 \
-		const topic##_zerv_topic_t *params);                                               \
-	zerv_msg_inst_t __##zervice_name##_##topic##_msg __aligned(4) = {                          \
-		.name = #zervice_name "_" #topic "_subscriber",                                    \
-		.id = __##zervice_name##_##topic##_id,                                             \
-		.is_locked = ATOMIC_INIT(false),                                                   \
-		.handler = (zerv_msg_abstract_handler_t)__##zervice_name##_##topic##_handler,      \
-		.is_raw = false,                                                                   \
-		.raw_handler = NULL};                                                              \
-	zerv_topic_subscriber_t __##zervice_name##_##topic __aligned(4) = {                        \
-		.msg_instance = &__##zervice_name##_##topic##_msg,                                 \
-		.serv = &zervice_name,                                                             \
+#define ZERV_TOPIC_DEF_HISTORY(topic_name, history_depth)                                          \
+	BUILD_ASSERT((history_depth) > 0, "The history depth of a topic must be positive");        \
+	static K_MUTEX_DEFINE(__##topic_name##_history_mtx);                                       \
+	static topic_name##_zerv_topic_t __##topic_name##_history_samples[history_depth];          \
+	static zerv_topic_history_t __##topic_name##_history = {                                   \
+		.mtx = &__##topic_name##_history_mtx,                                              \
+		.samples = (uint8_t *)__##topic_name##_history_samples,                            \
+		.sample_size = sizeof(topic_name##_zerv_topic_t),                                  \
+		.depth = history_depth,                                                            \
+		.head = 0,                                                                         \
+		.cnt = 0,                                                                          \
 	};                                                                                         \
-	void __##zervice_name##_##topic##_handler(const topic##_zerv_topic_t *params)
+	__ZERV_TOPIC_DEF(topic_name, #topic_name, false, &__##topic_name##_history)
+
+/**
+ * @brief Macro for defining a zervice topic handler function in a source file.
+ *
+ * The subscription is placed in a read-only iterable section, so the subscriber is known from
+ * boot and receives every event emitted on the topic, even before the zervice thread has started.
+ *
+ * @param zervice_name The name of the subscribing zervice.
+ * @param topic_name The name of the topic.
+ * @param params The name of the parameters of the topic event.
+ *
+ * @note The topic handler function must be defined in the same source file as the zervice
+ * 	 definition.
+ */
+#define ZERV_TOPIC_HANDLER(zervice_name, topic_name, params)                                       \
+	__unused static void __##zervice_name##_##topic_name##_handler(                            \
+		const topic_name##_zerv_topic_t *params);                                          \
+	__ZERV_TOPIC_SUBSCRIBER_DEF(zervice_name, topic_name,                                      \
+				    __##zervice_name##_##topic_name##_handler, NULL);              \
+	void __##zervice_name##_##topic_name##_handler(const topic_name##_zerv_topic_t *params)
+
+/**
+ * @brief Macro for defining a zervice topic handler function that receives blocks of events.
+ *
+ * The events of one ZERV_TOPIC_EMIT_BATCH are passed in a single call as a contiguous array,
+ * a single ZERV_TOPIC_EMIT is passed as an array of one event.
+ *
+ * @param zervice_name The name of the subscribing zervice.
+ * @param topic_name The name of the topic.
+ * @param samples The name of the array of topic events.
+ * @param cnt The name of the number of events in the array.
+ *
+ * @note The topic handler function must be defined in the same source file as the zervice
+ * 	 definition.
+ */
+#define ZERV_TOPIC_BATCH_HANDLER(zervice_name, topic_name, samples, cnt)                           \
+	__unused static void __##zervice_name##_##topic_name##_batch_handler(                      \
+		const topic_name##_zerv_topic_t *samples, size_t cnt);                             \
+	__ZERV_TOPIC_SUBSCRIBER_DEF(zervice_name, topic_name, NULL,                                \
+				    __##zervice_name##_##topic_name##_batch_handler);              \
+	void __##zervice_name##_##topic_name##_batch_handler(                                      \
+		const topic_name##_zerv_topic_t *samples, size_t cnt)
 
 /*=================================================================================================
  * ZERVICE TOPIC CLIENT MACROS
@@ -81,7 +156,78 @@
  * @param params The parameters of the event.
  */
 #define ZERV_TOPIC_EMIT(name, params...)                                                           \
-	zerv_internal_emit_topic(&name##_subscribers, sizeof(name##_zerv_topic_t),                 \
-				 &((name##_zerv_topic_t){params}));
+	zerv_internal_emit_topic(&__ZERV_TOPIC_IDENTIFIER(name), sizeof(name##_zerv_topic_t),      \
+				 &((name##_zerv_topic_t){params}), 1);
+
+/**
+ * @brief Macro for emitting a block of events over a topic.
+ *
+ * Each subscriber gets the whole block as one queued request, so the subscriber list is walked
+ * and each subscriber heap is allocated from once per block instead of once per event.
+ *
+ * @param name The name of the topic.
+ * @param samples Pointer to an array of name##_zerv_topic_t events.
+ * @param count The number of events in the array.
+ *
+ * @note The heap of every subscribing zervice must be able to hold the whole block.
+ */
+#define ZERV_TOPIC_EMIT_BATCH(name, samples, count)                                                \
+	zerv_internal_emit_topic(&__ZERV_TOPIC_IDENTIFIER(name), sizeof(name##_zerv_topic_t),      \
+				 (const name##_zerv_topic_t *){samples}, count);
+
+/**
+ * @brief Macro for emitting a event over a topic without doing the fan-out on the caller's
+ * thread.
+ *
+ * The event is copied to a queue served by a shared fan-out worker thread, which passes it on to
+ * the subscribers. The cost for the emitter is therefore independent of the number of
+ * subscribers, and on SMP targets the worker can be pinned to another CPU with
+ * CONFIG_ZERV_TOPIC_DEFERRED_CPU.
+ *
+ * @param name The name of the topic.
+ * @param params The parameters of the event.
+ *
+ * @note Requires CONFIG_ZERV_TOPIC_DEFERRED. Deferred events keep their order among themselves
+ * 	 but may be delivered after events emitted later with ZERV_TOPIC_EMIT.
+ */
+#define ZERV_TOPIC_EMIT_DEFERRED(name, params...)                                                  \
+	zerv_internal_emit_topic_deferred(&__ZERV_TOPIC_IDENTIFIER(name),                          \
+					  sizeof(name##_zerv_topic_t),                             \
+					  &((name##_zerv_topic_t){params}), 1);
+
+/**
+ * @brief Macro for emitting a block of events over a topic through the fan-out worker.
+ *
+ * @param name The name of the topic.
+ * @param samples Pointer to an array of name##_zerv_topic_t events.
+ * @param count The number of events in the array.
+ *
+ * @note See ZERV_TOPIC_EMIT_BATCH and ZERV_TOPIC_EMIT_DEFERRED.
+ */
+#define ZERV_TOPIC_EMIT_BATCH_DEFERRED(name, samples, count)                                       \
+	zerv_internal_emit_topic_deferred(&__ZERV_TOPIC_IDENTIFIER(name),                          \
+					  sizeof(name##_zerv_topic_t),                             \
+					  (const name##_zerv_topic_t *){samples}, count);
+
+/**
+ * @brief Macro for replaying the most recent events of a topic to a subscribing zervice.
+ *
+ * The events are queued to the zervice oldest first, in one operation and while holding the lock
+ * that serializes the emissions on the topic. No event emitted concurrently can therefore end up
+ * in between or in front of the replayed ones.
+ *
+ * @param zervice_name The name of the subscribing zervice.
+ * @param topic_name The name of the topic, which must be defined with ZERV_TOPIC_DEF_HISTORY.
+ * @param cnt The maximum number of events to replay.
+ *
+ * @return ZERV_RC_OK on success, otherwise a negative ZERV_RC code.
+ *
+ * @note Subscriptions are active from boot, so events still queued for the zervice are not
+ * removed and may be received again as part of the replay.
+ */
+#define ZERV_TOPIC_REPLAY(zervice_name, topic_name, cnt)                                           \
+	zerv_internal_replay_topic(&__ZERV_TOPIC_IDENTIFIER(topic_name),                           \
+				   &__ZERV_TOPIC_SUBSCRIBER_IDENTIFIER(topic_name, zervice_name),  \
+				   cnt)
 
 #endif /* _ZERV_TOPIC_H_ */
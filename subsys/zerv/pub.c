@@ -18,9 +18,83 @@
 #include <zephyr/logging/log.h>
 #include <stdint.h>
 #include <stddef.h>
+#include <string.h>
 
 LOG_MODULE_REGISTER(pub, CONFIG_ZERV_LOG_LEVEL);
 
+/**
+ * @brief Enter the active subscriber set of a publisher as an emitter.
+ *
+ * The reader count of the set is raised before the set is confirmed to still be the active one,
+ * so a writer that has seen the count drop to zero can never have an emitter enter the set it is
+ * about to change.
+ *
+ * @return The entered subscriber set, which must be left with pub_subscribers_leave.
+ */
+static struct pub_subscribers *pub_subscribers_enter(struct pub *pub)
+{
+	while (true) {
+		atomic_val_t active = atomic_get(&pub->active);
+		atomic_inc(&pub->sets[active].readers);
+		if (atomic_get(&pub->active) == active) {
+			return &pub->sets[active];
+		}
+		atomic_dec(&pub->sets[active].readers);
+	}
+}
+
+static void pub_subscribers_leave(struct pub_subscribers *set)
+{
+	atomic_dec(&set->readers);
+}
+
+/**
+ * @brief Wait for the emitters that entered a subscriber set to leave it.
+ * @note The set must not be the active one, or new emitters may keep entering it.
+ */
+static void pub_subscribers_drain(struct pub_subscribers *set)
+{
+	while (atomic_get(&set->readers) != 0) {
+		k_sleep(K_TICKS(1));
+	}
+}
+
+/**
+ * @brief Get the inactive subscriber set of a publisher, prepared as a copy of the active one.
+ * @note Must be called with the publisher mutex held.
+ */
+static struct pub_subscribers *pub_subscribers_prepare(struct pub *pub)
+{
+	atomic_val_t active = atomic_get(&pub->active);
+	struct pub_subscribers *next = &pub->sets[!active];
+
+	// Emitters that entered the set before it was replaced may still be walking it.
+	pub_subscribers_drain(next);
+
+	memcpy(next->subs, pub->sets[active].subs, pub->sets[active].cnt * sizeof(struct sub *));
+	next->cnt = pub->sets[active].cnt;
+	return next;
+}
+
+/**
+ * @brief Make a prepared subscriber set the active one.
+ * @note Must be called with the publisher mutex held.
+ */
+static void pub_subscribers_publish(struct pub *pub, struct pub_subscribers *next)
+{
+	atomic_set(&pub->active, next - pub->sets);
+}
+
+static bool pub_subscribers_contains(const struct pub_subscribers *set, const struct sub *sub)
+{
+	for (size_t i = 0; i < set->cnt; i++) {
+		if (set->subs[i] == sub) {
+			return true;
+		}
+	}
+	return false;
+}
+
 int pub_add_subscriber(struct pub *pub, struct sub *sub)
 {
 	if (pub == NULL || sub == NULL) {
@@ -28,13 +102,31 @@ int pub_add_subscriber(struct pub *pub, struct sub *sub)
 		return -EINVAL;
 	}
 
+	if (pub->item_size != 0 && sub->msgq != NULL && sub->msgq->msg_size != pub->item_size) {
+		LOG_ERR("Subscriber %s records do not match the records of %s", sub->name,
+			pub->name);
+		return -EINVAL;
+	}
+
 	int rc = 0;
 	rc = k_mutex_lock(pub->mtx, K_FOREVER);
 	if (rc < 0) {
 		LOG_ERR("Failed to lock %s mutex (%i) %s", pub->name, rc, strerror(-rc));
 		return rc;
 	}
-	sys_slist_append(&pub->subscribers, &sub->node);
+
+	struct pub_subscribers *next = pub_subscribers_prepare(pub);
+	if (pub_subscribers_contains(next, sub)) {
+		rc = -EALREADY;
+	} else if (next->cnt == pub->max_subscribers) {
+		LOG_ERR("Publisher %s can not have more than %d subscribers", pub->name,
+			(int)pub->max_subscribers);
+		rc = -ENOMEM;
+	} else {
+		next->subs[next->cnt++] = sub;
+		pub_subscribers_publish(pub, next);
+	}
+
 	k_mutex_unlock(pub->mtx);
 	return rc;
 }
@@ -53,34 +145,127 @@ int pub_remove_subscriber(struct pub *pub, struct sub *sub)
 		return rc;
 	}
 
-	sys_slist_find_and_remove(&pub->subscribers, &sub->node);
+	struct pub_subscribers *prev = &pub->sets[atomic_get(&pub->active)];
+	struct pub_subscribers *next = pub_subscribers_prepare(pub);
+	rc = -ENOENT;
+	for (size_t i = 0; i < next->cnt; i++) {
+		if (next->subs[i] == sub) {
+			next->cnt--;
+			memmove(&next->subs[i], &next->subs[i + 1],
+				(next->cnt - i) * sizeof(struct sub *));
+			pub_subscribers_publish(pub, next);
+			// An emitter still walking the replaced set may notify the subscriber,
+			// which the caller must be able to tear down once this returns.
+			pub_subscribers_drain(prev);
+			rc = 0;
+			break;
+		}
+	}
+
 	k_mutex_unlock(pub->mtx);
 	return rc;
 }
 
+/**
+ * @brief Emit data as one notification payload shared by all subscribers.
+ *
+ * The payload and a notification handle for each subscriber are placed in a single allocation
+ * on the publisher's heap, which the subscribers free together by dropping their references.
+ */
+static int pub_emit_shared(struct pub *pub, struct pub_subscribers *set, const void *data,
+			   size_t size, struct pub_emit_result *result)
+{
+	size_t cnt = set->cnt;
+	if (cnt == 0) {
+		return 0;
+	}
+
+	struct notification *notifications = k_heap_alloc(
+		pub->heap,
+		cnt * sizeof(struct notification) + sizeof(struct notification_payload) + size,
+		K_NO_WAIT);
+	if (notifications == NULL) {
+		LOG_ERR("Failed to allocate shared notification on %s", pub->name);
+		for (size_t i = 0; i < cnt; i++) {
+			atomic_inc(&set->subs[i]->dropped);
+		}
+		result->dropped = cnt;
+		return -ENOMEM;
+	}
+
+	struct notification_payload *payload =
+		(struct notification_payload *)&notifications[cnt];
+	atomic_set(&payload->refcnt, cnt);
+	payload->heap = pub->heap;
+	payload->ring = NULL;
+	payload->pool = NULL;
+	payload->block = notifications;
+	memcpy(payload->data, data, size);
+
+	int rc = 0;
+	for (size_t i = 0; i < cnt; i++) {
+		notifications[i].emittor = pub;
+		notifications[i].size = size;
+		notifications[i].payload = payload;
+		int sub_rc = sub_notify_shared(set->subs[i], &notifications[i]);
+		if (sub_rc < 0) {
+			LOG_ERR("Failed to notify subscriber %s", set->subs[i]->name);
+			result->dropped++;
+			rc = sub_rc;
+		} else {
+			result->delivered++;
+		}
+	}
+
+	return rc;
+}
+
 int pub_emit(struct pub *pub, const void *data, size_t size)
 {
+	return pub_emit_with_result(pub, data, size, NULL);
+}
+
+int pub_emit_with_result(struct pub *pub, const void *data, size_t size,
+			 struct pub_emit_result *result)
+{
+	struct pub_emit_result local;
+	if (result == NULL) {
+		result = &local;
+	}
+	result->delivered = 0;
+	result->dropped = 0;
+
 	if (pub == NULL || data == NULL || size == 0) {
 		LOG_DBG("Invalid arguments: pub: %p, data: %p, size: %d", pub, data, size);
 		return -EINVAL;
 	}
 
+	if (pub->item_size != 0 && size != pub->item_size) {
+		LOG_ERR("Size %d does not match the records of %s", (int)size, pub->name);
+		return -EINVAL;
+	}
+
 	int rc = 0;
-	rc = k_mutex_lock(pub->mtx, K_FOREVER);
-	if (rc < 0) {
-		LOG_ERR("Failed to lock %s mutex (%i) %s", pub->name, rc, strerror(-rc));
+	struct pub_subscribers *set = pub_subscribers_enter(pub);
+	if (pub->heap != NULL) {
+		rc = pub_emit_shared(pub, set, data, size, result);
+		pub_subscribers_leave(set);
 		return rc;
 	}
-	sys_snode_t *node = sys_slist_peek_head(&pub->subscribers);
-	while (node) {
-		struct sub *sub = CONTAINER_OF(node, struct sub, node);
-		rc = sub_notify(sub, pub, data, size);
-		if (rc < 0) {
+
+	// A subscriber that can not take the notification is skipped, so that the loss stays
+	// isolated to it instead of starving the subscribers after it.
+	for (size_t i = 0; i < set->cnt; i++) {
+		struct sub *sub = set->subs[i];
+		int sub_rc = sub_notify(sub, pub, data, size);
+		if (sub_rc < 0) {
 			LOG_ERR("Failed to notify subscriber %s", sub->name);
-			break;
+			result->dropped++;
+			rc = sub_rc;
+		} else {
+			result->delivered++;
 		}
-		node = sys_slist_peek_next(node);
 	}
-	k_mutex_unlock(pub->mtx);
+	pub_subscribers_leave(set);
 	return rc;
 }
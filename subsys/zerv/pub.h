@@ -15,26 +15,86 @@
 #define _PUB_H_
 
 #include <zephyr/kernel.h>
-#include <zephyr/sys/slist.h>
+#include <zephyr/sys/atomic.h>
 #include <stdint.h>
 #include <stddef.h>
 
 struct sub; // Forward declaration.
 
+/**
+ * @brief One of the two copies of the subscriber set of a publisher.
+ */
+struct pub_subscribers {
+	struct sub **subs;
+	size_t cnt;
+	atomic_t readers; // Number of emitters currently walking this copy.
+};
+
+/**
+ * @brief A publisher.
+ *
+ * The subscriber set is kept in two copies of which one is active. Emitters walk the active copy
+ * without taking any lock, while adding or removing a subscriber takes the mutex, waits for the
+ * emitters to leave the inactive copy, updates it and makes it the active one.
+ */
 struct pub {
 	const char *name;
-	struct k_mutex *mtx;
-	sys_slist_t subscribers;
+	struct k_mutex *mtx; // Serializes the changes to the subscriber set.
+	struct pub_subscribers sets[2];
+	atomic_t active;
+	size_t max_subscribers;
+	struct k_heap *heap; // Heap for shared notifications, NULL if each subscriber gets a copy.
+	size_t item_size;    // Size of every notification of a typed publisher, 0 if untyped.
 };
 
+#define __PUB_DEFINE(pub_name, pub_heap, pub_item_size)                                            \
+	K_MUTEX_DEFINE(pub_##pub_name##_mtx);                                                      \
+	static struct sub *pub_##pub_name##_subs[2][CONFIG_ZERV_PUB_MAX_SUBSCRIBERS];              \
+	struct pub pub_name = {                                                                    \
+		.name = #pub_name,                                                                 \
+		.mtx = &pub_##pub_name##_mtx,                                                      \
+		.sets = {{.subs = pub_##pub_name##_subs[0], .cnt = 0, .readers = ATOMIC_INIT(0)},  \
+			 {.subs = pub_##pub_name##_subs[1], .cnt = 0, .readers = ATOMIC_INIT(0)}}, \
+		.active = ATOMIC_INIT(0),                                                          \
+		.max_subscribers = CONFIG_ZERV_PUB_MAX_SUBSCRIBERS,                                \
+		.heap = pub_heap,                                                                  \
+		.item_size = pub_item_size,                                                        \
+	};
+
 /**
  * @brief Macro for defining a publisher.
  * @param pub_name The name of the publisher.
+ * @note A publisher can have at most CONFIG_ZERV_PUB_MAX_SUBSCRIBERS subscribers.
  */
-#define PUB_DEFINE(pub_name)                                                                       \
-	K_MUTEX_DEFINE(pub_##pub_name##_mtx);                                                      \
-	struct pub pub_name = {                                                                    \
-		.name = #pub_name, .mtx = &pub_##pub_name##_mtx, .subscribers = {NULL}};
+#define PUB_DEFINE(pub_name) __PUB_DEFINE(pub_name, NULL, 0)
+
+/**
+ * @brief Macro for defining a publisher that shares each emitted notification between its
+ * subscribers.
+ *
+ * Each emission makes one allocation on the publisher's heap holding the data and one small
+ * notification handle per subscriber, instead of one copy of the data per subscriber. The data
+ * is freed when the last subscriber has called sub_free on it.
+ *
+ * @param pub_name The name of the publisher.
+ * @param heap_size The size of the heap holding the notifications in flight.
+ */
+#define PUB_DEFINE_SHARED(pub_name, heap_size)                                                     \
+	static K_HEAP_DEFINE(pub_##pub_name##_heap, heap_size);                                    \
+	__PUB_DEFINE(pub_name, &pub_##pub_name##_heap, 0)
+
+/**
+ * @brief Macro for defining a publisher of fixed-size records of one type.
+ *
+ * Every notification of the publisher is exactly sizeof(type) bytes. Emit with PUB_EMIT_TYPED so
+ * that the type of the data is checked at compile time.
+ *
+ * @param pub_name The name of the publisher.
+ * @param type The type of the records.
+ */
+#define PUB_DEFINE_TYPED(pub_name, type)                                                           \
+	typedef type pub_name##_type_t;                                                            \
+	__PUB_DEFINE(pub_name, NULL, sizeof(type))
 
 /**
  * @brief Macro for declaring a publisher.
@@ -42,35 +102,98 @@ struct pub {
  */
 #define PUB_DECLARE(pub_name) extern struct pub pub_name;
 
+/**
+ * @brief Macro for declaring a publisher defined with PUB_DEFINE_TYPED.
+ * @param pub_name The name of the publisher.
+ * @param type The type of the records.
+ */
+#define PUB_DECLARE_TYPED(pub_name, type)                                                          \
+	typedef type pub_name##_type_t;                                                            \
+	extern struct pub pub_name;
+
+/**
+ * @brief Emit a record on a publisher defined with PUB_DEFINE_TYPED.
+ * @param pub_name The name of the publisher.
+ * @param value Pointer to the record, must point to the type of the publisher.
+ * @return See pub_emit.
+ */
+#define PUB_EMIT_TYPED(pub_name, value)                                                            \
+	pub_emit(&(pub_name), (const pub_name##_type_t *){value}, sizeof(pub_name##_type_t))
+
+/**
+ * @brief Add a subscriber defined with SUB_DEFINE_TYPED to a publisher defined with
+ * PUB_DEFINE_TYPED, checking at compile time that their records are of the same size.
+ * @param pub_name The name of the publisher.
+ * @param sub_name The name of the subscriber.
+ * @return See pub_add_subscriber.
+ */
+#define PUB_ADD_SUBSCRIBER_TYPED(pub_name, sub_name)                                               \
+	(pub_add_subscriber(&(pub_name), &(sub_name)) +                                            \
+	 0 * (int)sizeof(char[sizeof(pub_name##_type_t) == sizeof(sub_name##_type_t) ? 1 : -1]))
+
 /**
  * @brief Add a subscriber to a publisher.
  *
  * @param pub The publisher.
  * @param sub The subscriber.
  *
- * @return 0 on success, negative errno otherwise.
+ * @return 0 on success, -EALREADY if the subscriber is already added, -ENOMEM if the publisher
+ * has no room for more subscribers, -EINVAL if the records of a typed publisher and subscriber
+ * differ in size, negative errno otherwise.
  */
 int pub_add_subscriber(struct pub *pub, struct sub *sub);
 
 /**
  * @brief Remove a subscriber from a publisher.
  *
+ * Returns once no emission can notify the subscriber anymore, so the subscriber may be torn down
+ * right after.
+ *
  * @param pub The publisher.
  * @param sub The subscriber.
  *
- * @return 0 on success, negative errno otherwise.
+ * @return 0 on success, -ENOENT if the subscriber is not subscribed to the publisher, negative
+ * errno otherwise.
  */
 int pub_remove_subscriber(struct pub *pub, struct sub *sub);
 
+/**
+ * @brief The outcome of one emission.
+ */
+struct pub_emit_result {
+	size_t delivered; // Number of subscribers the notification was queued to.
+	size_t dropped;   // Number of subscribers that could not take the notification.
+};
+
 /**
  * @brief Emit data to all subscribers of a publisher.
  *
+ * The subscriber set is walked without locking the publisher, so any number of emitters can emit
+ * on the same publisher concurrently. A subscriber that can not take the notification does not
+ * stop the emission, it is counted as dropped and the remaining subscribers are still notified.
+ *
  * @param pub The publisher.
  * @param data The data to emit.
  * @param size The size of the data.
  *
- * @return 0 on success, negative errno otherwise.
+ * @return 0 if all subscribers were notified, negative errno of the last failed subscriber
+ * otherwise.
  */
 int pub_emit(struct pub *pub, const void *data, size_t size);
 
+/**
+ * @brief Emit data to all subscribers of a publisher and report the number of subscribers that
+ * were notified.
+ *
+ * @param pub The publisher.
+ * @param data The data to emit.
+ * @param size The size of the data.
+ * @param[out] result The number of delivered and dropped notifications, can be NULL.
+ *
+ * @return 0 if all subscribers were notified, negative errno of the last failed subscriber
+ * otherwise.
+ */
+int pub_emit_with_result(struct pub *pub, const void *data, size_t size,
+			 struct pub_emit_result *result);
+
 #endif // _PUB_H_
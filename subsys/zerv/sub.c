@@ -25,6 +25,158 @@ LOG_MODULE_REGISTER(sub, CONFIG_ZERV_LOG_LEVEL);
  */
 static void sub_free_internal(struct sub *_sub);
 
+/**
+ * @brief Drop a reference to a notification payload, freeing it when it was the last one.
+ * @param[in] payload The payload to release.
+ */
+static void notification_payload_release(struct notification_payload *payload)
+{
+	if (atomic_dec(&payload->refcnt) != 1) {
+		return;
+	}
+
+	if (payload->ring != NULL) {
+		sub_ring_release(payload->ring);
+		return;
+	}
+
+	if (payload->pool != NULL) {
+		sub_pool_free(payload->pool, payload->block);
+		return;
+	}
+
+#if defined(CONFIG_ZTEST) && defined(CONFIG_SYS_HEAP_RUNTIME_STATS)
+	struct sys_memory_stats memstat;
+	sys_heap_runtime_stats_get(&payload->heap->heap, &memstat);
+#endif
+
+	struct k_heap *heap = payload->heap;
+	k_heap_free(heap, payload->block);
+
+#if defined(CONFIG_ZTEST) && defined(CONFIG_SYS_HEAP_RUNTIME_STATS)
+	struct sys_memory_stats post_memstat;
+	sys_heap_runtime_stats_get(&heap->heap, &post_memstat);
+	LOG_DBG("heap diff after free: %i heap usage: %d bytes of %d total -> %d %%",
+		(int)post_memstat.free_bytes - (int)memstat.free_bytes,
+		post_memstat.allocated_bytes, heap->heap.init_bytes,
+		(post_memstat.allocated_bytes * 100) / heap->heap.init_bytes);
+#endif
+}
+
+/**
+ * @brief Get the semaphore counting the queued notifications of a ring or lock-free subscriber.
+ * @return The semaphore, NULL if the notifications are queued in a fifo.
+ */
+static struct k_sem *sub_sem(struct sub *sub)
+{
+	if (sub->ring != NULL) {
+		return sub->ring->sem;
+	}
+	if (sub->pool != NULL) {
+		return sub->pool->sem;
+	}
+	return NULL;
+}
+
+/**
+ * @brief Get the next notification queued to a subscriber.
+ * @param[in] sub The subscriber.
+ * @param[in] timeout The timeout for waiting for a notification.
+ * @return The notification, NULL if none was queued before the timeout.
+ */
+static struct notification *sub_get(struct sub *sub, k_timeout_t timeout)
+{
+	if (sub->ring == NULL && sub->pool == NULL) {
+		return k_fifo_get(sub->fifo, timeout);
+	}
+
+	if (k_sem_take(sub_sem(sub), timeout) != 0) {
+		return NULL;
+	}
+	if (sub->pool != NULL) {
+		return sub_pool_get(sub->pool);
+	}
+	k_mutex_lock(sub->mtx, K_FOREVER);
+	struct notification *notification = sub_ring_get(sub->ring);
+	k_mutex_unlock(sub->mtx);
+	return notification;
+}
+
+/**
+ * @brief Count the outcome of passing a notification to a subscriber.
+ * @return The passed return code.
+ */
+static int sub_count(struct sub *sub, int rc)
+{
+	if (rc == 0) {
+		atomic_inc(&sub->delivered);
+	} else if (rc == -ENOMEM) {
+		atomic_inc(&sub->dropped);
+	}
+	return rc;
+}
+
+/**
+ * @brief Copy a notification into the ring of a ring backed subscriber.
+ * @return 0 on success, -ENOMEM if the ring is full.
+ */
+static int sub_notify_ring(struct sub *sub, struct pub *emittor, const void *_data,
+			   size_t _data_size)
+{
+	k_mutex_lock(sub->mtx, K_FOREVER);
+	struct notification *p_msg = sub_ring_alloc(sub->ring, _data_size);
+	if (p_msg == NULL) {
+		LOG_ERR("No room in ring for subscriber %s", sub->name);
+		k_mutex_unlock(sub->mtx);
+		return -ENOMEM;
+	}
+	p_msg->emittor = emittor;
+	memcpy(p_msg->payload->data, _data, _data_size);
+	k_mutex_unlock(sub->mtx);
+
+	k_sem_give(sub->ring->sem);
+	return 0;
+}
+
+/**
+ * @brief Copy a notification into a slot of a lock-free subscriber.
+ * @return 0 on success, -ENOMEM if all slots are in use.
+ */
+static int sub_notify_pool(struct sub *sub, const struct pub *emittor, const void *_data,
+			   size_t _data_size)
+{
+	struct notification *p_msg = sub_pool_alloc(sub->pool, _data_size);
+	if (p_msg == NULL) {
+		LOG_ERR("No free slot for subscriber %s", sub->name);
+		return -ENOMEM;
+	}
+	p_msg->emittor = emittor;
+	memcpy(p_msg->payload->data, _data, _data_size);
+	sub_pool_put(sub->pool, p_msg);
+
+	k_sem_give(sub->pool->sem);
+	return 0;
+}
+
+/**
+ * @brief Copy a record into the message queue of a typed subscriber.
+ * @return 0 on success, -ENOMEM if the queue is full, -EINVAL if the size does not match.
+ */
+static int sub_notify_typed(struct sub *sub, const void *_data, size_t _data_size)
+{
+	if (_data_size != sub->msgq->msg_size) {
+		LOG_ERR("Size %d does not match the records of subscriber %s", (int)_data_size,
+			sub->name);
+		return -EINVAL;
+	}
+
+	if (k_msgq_put(sub->msgq, _data, K_NO_WAIT) != 0) {
+		LOG_ERR("No room in queue for subscriber %s", sub->name);
+		return -ENOMEM;
+	}
+	return 0;
+}
+
 /**
  * @brief Send a notification to a subscriber.
  * @param[in] emittor The publisher that emitted the notification.
@@ -43,6 +195,16 @@ int sub_notify(struct sub *sub, struct pub *emittor, const void *_data, size_t _
 
 	LOG_DBG("Sending notification from publisher %s @ %p to subscriber %s @ %p with size %d",
 		emittor->name, emittor, sub->name, sub, _data_size);
+	if (sub->ring != NULL) {
+		return sub_count(sub, sub_notify_ring(sub, emittor, _data, _data_size));
+	}
+	if (sub->msgq != NULL) {
+		return sub_count(sub, sub_notify_typed(sub, _data, _data_size));
+	}
+	if (sub->pool != NULL) {
+		return sub_count(sub, sub_notify_pool(sub, emittor, _data, _data_size));
+	}
+
 	k_mutex_lock(sub->mtx, K_FOREVER);
 
 #if defined(CONFIG_ZTEST) && defined(CONFIG_SYS_HEAP_RUNTIME_STATS)
@@ -50,8 +212,12 @@ int sub_notify(struct sub *sub, struct pub *emittor, const void *_data, size_t _
 	sys_heap_runtime_stats_get(&sub->heap->heap, &memstat);
 #endif
 
+	// The notification and its payload are placed in one allocation owned by this subscriber.
 	struct notification *p_msg =
-		k_heap_alloc(sub->heap, _data_size + sizeof(struct notification), K_NO_WAIT);
+		k_heap_alloc(sub->heap,
+			     sizeof(struct notification) + sizeof(struct notification_payload) +
+				     _data_size,
+			     K_NO_WAIT);
 
 #if defined(CONFIG_ZTEST) && defined(CONFIG_SYS_HEAP_RUNTIME_STATS)
 	struct sys_memory_stats post_memstat;
@@ -65,27 +231,80 @@ int sub_notify(struct sub *sub, struct pub *emittor, const void *_data, size_t _
 	if (p_msg == NULL) {
 		LOG_ERR("Failed to allocate message for subscriber %s", sub->name);
 		k_mutex_unlock(sub->mtx);
-		return -ENOMEM;
+		return sub_count(sub, -ENOMEM);
 	}
 
+	struct notification_payload *payload = (struct notification_payload *)(p_msg + 1);
+	atomic_set(&payload->refcnt, 1);
+	payload->heap = sub->heap;
+	payload->ring = NULL;
+	payload->block = p_msg;
+	memcpy(payload->data, _data, _data_size);
+
 	p_msg->emittor = emittor;
 	p_msg->size = _data_size;
-	memcpy(p_msg->data, _data, _data_size);
+	p_msg->payload = payload;
 	k_fifo_put(sub->fifo, p_msg);
 	k_mutex_unlock(sub->mtx);
 
 	LOG_DBG("Publisher %s @ %p sending notification to subscriber %s @ %p with size %d",
 		p_msg->emittor->name, p_msg->emittor, sub->name, sub, p_msg->size);
 
+	return sub_count(sub, 0);
+}
+
+int sub_notify_shared(struct sub *sub, struct notification *notification)
+{
+	LOG_DBG("Publisher %s @ %p sending shared notification to subscriber %s @ %p with size %d",
+		notification->emittor->name, notification->emittor, sub->name, sub,
+		notification->size);
+	if (sub->ring != NULL) {
+		// A ring holds its notifications by value, so the shared payload is copied into it.
+		int rc = sub_notify_ring(sub, (struct pub *)notification->emittor,
+					 notification->payload->data, notification->size);
+		notification_payload_release(notification->payload);
+		return sub_count(sub, rc);
+	}
+	if (sub->msgq != NULL) {
+		int rc = sub_notify_typed(sub, notification->payload->data, notification->size);
+		notification_payload_release(notification->payload);
+		return sub_count(sub, rc);
+	}
+	if (sub->pool != NULL) {
+		int rc = sub_notify_pool(sub, notification->emittor, notification->payload->data,
+					 notification->size);
+		notification_payload_release(notification->payload);
+		return sub_count(sub, rc);
+	}
+
+	k_fifo_put(sub->fifo, notification);
+	return sub_count(sub, 0);
+}
+
+int sub_receive_typed(struct sub *sub, void *value, k_timeout_t timeout)
+{
+	if (sub == NULL || sub->msgq == NULL || value == NULL) {
+		return -EINVAL;
+	}
+
+	if (k_msgq_get(sub->msgq, value, timeout) != 0) {
+		return -EAGAIN;
+	}
 	return 0;
 }
 
+void sub_stats_get(struct sub *sub, struct sub_stats *stats)
+{
+	stats->delivered = (uint32_t)atomic_get(&sub->delivered);
+	stats->dropped = (uint32_t)atomic_get(&sub->dropped);
+}
+
 int sub_wait(struct sub *sub, k_timeout_t timeout)
 {
-	if (sub == NULL) {
+	if (sub == NULL || sub->msgq != NULL) {
 		return -EINVAL;
 	} else {
-		struct notification *notification = k_fifo_get(sub->fifo, timeout);
+		struct notification *notification = sub_get(sub, timeout);
 		if (notification == NULL) {
 			return -EAGAIN;
 		}
@@ -103,14 +322,14 @@ int sub_wait(struct sub *sub, k_timeout_t timeout)
 
 void *sub_receive(struct sub *sub, size_t *recv_size)
 {
-	if (sub == NULL) {
+	if (sub == NULL || sub->msgq != NULL) {
 		return NULL;
 	} else {
 		// It might be that the application was signalled through the polling API
 		// that a notification is available, but the application has not yet called
 		// sub_receive_internal() to actually receive the notification.
 		if (sub->last_notification == NULL) {
-			sub->last_notification = k_fifo_get(sub->fifo, K_NO_WAIT);
+			sub->last_notification = sub_get(sub, K_NO_WAIT);
 			if (sub->last_notification == NULL) {
 				return NULL;
 			}
@@ -119,66 +338,264 @@ void *sub_receive(struct sub *sub, size_t *recv_size)
 		if (recv_size) {
 			*recv_size = sub->last_notification->size;
 		}
-		return sub->last_notification->data;
+		return sub->last_notification->payload->data;
 	}
 }
 
 void sub_free(struct sub *sub, void *buf)
 {
+	struct notification_payload *payload =
+		(struct notification_payload *)CONTAINER_OF(buf, struct notification_payload, data);
+
+	if (sub->pool != NULL) {
+		// The slot is returned to the pool without locking, the last notification is only
+		// touched by the receiving thread.
+		if (sub->last_notification != NULL &&
+		    sub->last_notification->payload->data == buf) {
+			sub->last_notification = NULL;
+		}
+		notification_payload_release(payload);
+		return;
+	}
+
 	if (k_mutex_lock(sub->mtx, K_FOREVER) < 0) {
 		LOG_ERR("Failed to lock mutex for subscriber %s", sub->name);
 		return;
 	}
 
-#if defined(CONFIG_ZTEST) && defined(CONFIG_SYS_HEAP_RUNTIME_STATS)
-	struct sys_memory_stats memstat;
-	sys_heap_runtime_stats_get(&sub->heap->heap, &memstat);
-#endif
+	if (sub->last_notification != NULL && sub->last_notification->payload->data == buf) {
+		sub->last_notification = NULL;
+	}
+
+	notification_payload_release(payload);
+
+	k_mutex_unlock(sub->mtx);
+}
+
+/**
+ * @brief Fill in a view of a notification.
+ */
+static void sub_view_set(struct sub_view *view, const struct notification *notification)
+{
+	view->emittor = notification->emittor;
+	view->data = notification->payload->data;
+	view->size = notification->size;
+}
+
+int sub_receive_many(struct sub *sub, struct sub_view *views, size_t max, k_timeout_t timeout)
+{
+	if (sub == NULL || sub->msgq != NULL || views == NULL || max == 0) {
+		return -EINVAL;
+	}
+
+	size_t cnt = 0;
 
-	if (sub->last_notification->data == buf) {
+	// A notification already taken by sub_wait is handed out first.
+	if (sub->last_notification != NULL) {
+		sub_view_set(&views[cnt++], sub->last_notification);
 		sub->last_notification = NULL;
 	}
 
-	struct notification *notification =
-		(struct notification *)CONTAINER_OF(buf, struct notification, data);
+	struct k_sem *sem = sub_sem(sub);
+	if (sem != NULL) {
+		// Count the notifications to take on the semaphore first, so that a ring only has
+		// to be locked once for all of them. A lock-free pool is not locked at all.
+		size_t take = 0;
+		if (cnt == 0) {
+			if (k_sem_take(sem, timeout) != 0) {
+				return -EAGAIN;
+			}
+			take++;
+		}
+		while (cnt + take < max && k_sem_take(sem, K_NO_WAIT) == 0) {
+			take++;
+		}
 
-	k_heap_free(sub->heap, notification);
+		if (sub->pool != NULL) {
+			for (size_t i = 0; i < take; i++) {
+				sub_view_set(&views[cnt++], sub_pool_get(sub->pool));
+			}
+		} else {
+			k_mutex_lock(sub->mtx, K_FOREVER);
+			for (size_t i = 0; i < take; i++) {
+				sub_view_set(&views[cnt++], sub_ring_get(sub->ring));
+			}
+			k_mutex_unlock(sub->mtx);
+		}
+	} else {
+		struct notification *notification;
+		if (cnt == 0) {
+			notification = k_fifo_get(sub->fifo, timeout);
+			if (notification == NULL) {
+				return -EAGAIN;
+			}
+			sub_view_set(&views[cnt++], notification);
+		}
+		while (cnt < max && (notification = k_fifo_get(sub->fifo, K_NO_WAIT)) != NULL) {
+			sub_view_set(&views[cnt++], notification);
+		}
+	}
 
-#if defined(CONFIG_ZTEST) && defined(CONFIG_SYS_HEAP_RUNTIME_STATS)
-	struct sys_memory_stats post_memstat;
-	sys_heap_runtime_stats_get(&sub->heap->heap, &post_memstat);
-	LOG_DBG("%s heap diff after free: %i heap usage: %d bytes of %d total -> %d %%", sub->name,
-		(int)post_memstat.free_bytes - (int)memstat.free_bytes,
-		post_memstat.allocated_bytes, sub->heap->heap.init_bytes,
-		(post_memstat.allocated_bytes * 100) / sub->heap->heap.init_bytes);
-#endif
+	LOG_DBG("Received %d notifications on subscriber %s @ %p", cnt, sub->name, sub);
+	return cnt;
+}
+
+void sub_free_many(struct sub *sub, const struct sub_view *views, size_t cnt)
+{
+	if (sub == NULL || views == NULL) {
+		return;
+	}
+
+	if (sub->pool != NULL) {
+		for (size_t i = 0; i < cnt; i++) {
+			sub_free(sub, views[i].data);
+		}
+		return;
+	}
+
+	k_mutex_lock(sub->mtx, K_FOREVER);
+
+	bool ring_freed = false;
+	for (size_t i = 0; i < cnt; i++) {
+		if (sub->last_notification != NULL &&
+		    sub->last_notification->payload->data == views[i].data) {
+			sub->last_notification = NULL;
+		}
+
+		struct notification_payload *payload = (struct notification_payload *)CONTAINER_OF(
+			views[i].data, struct notification_payload, data);
+		if (payload->ring != NULL) {
+			// The space of the ring is reclaimed for all records at once below.
+			atomic_dec(&payload->refcnt);
+			ring_freed = true;
+		} else {
+			notification_payload_release(payload);
+		}
+	}
+
+	if (ring_freed) {
+		sub_ring_release(sub->ring);
+	}
 
 	k_mutex_unlock(sub->mtx);
 }
 
+/**
+ * @brief Sequence used to stamp the subscribers served by sub_wait_any.
+ */
+static atomic_t sub_served_seq = ATOMIC_INIT(0);
+
+/**
+ * @brief Check if a subscriber has a notification that can be taken without waiting.
+ */
+static bool sub_is_ready(struct sub *sub)
+{
+	if (sub->last_notification != NULL) {
+		return true;
+	}
+	struct k_sem *sem = sub_sem(sub);
+	if (sem != NULL) {
+		return k_sem_count_get(sem) > 0;
+	}
+	return !k_fifo_is_empty(sub->fifo);
+}
+
+/**
+ * @brief Take a notification from the ready subscriber that was served the longest ago.
+ * @return The subscriber, NULL if no subscriber had a notification.
+ */
+static struct sub *sub_take_any(struct sub *const subs[], size_t n,
+				struct notification **notification)
+{
+	while (true) {
+		struct sub *next = NULL;
+		for (size_t i = 0; i < n; i++) {
+			if (!sub_is_ready(subs[i])) {
+				continue;
+			}
+			if (next == NULL || (int32_t)(subs[i]->served - next->served) < 0) {
+				next = subs[i];
+			}
+		}
+		if (next == NULL) {
+			return NULL;
+		}
+
+		next->served = (uint32_t)atomic_inc(&sub_served_seq) + 1;
+
+		// A notification already taken by sub_wait is handed out first.
+		if (next->last_notification != NULL) {
+			*notification = next->last_notification;
+			next->last_notification = NULL;
+			return next;
+		}
+
+		// Another thread may have taken the notification since the check, in which case the
+		// subscribers are scanned again.
+		*notification = sub_get(next, K_NO_WAIT);
+		if (*notification != NULL) {
+			return next;
+		}
+	}
+}
+
+struct sub *sub_wait_any(struct sub *const subs[], size_t n, struct sub_view *view,
+			 k_timeout_t timeout)
+{
+	if (subs == NULL || view == NULL || n == 0 || n > CONFIG_ZERV_SUB_WAIT_ANY_MAX) {
+		return NULL;
+	}
+	for (size_t i = 0; i < n; i++) {
+		if (subs[i]->msgq != NULL) {
+			LOG_ERR("Typed subscriber %s can not be waited on", subs[i]->name);
+			return NULL;
+		}
+	}
+
+	struct k_poll_event events[CONFIG_ZERV_SUB_WAIT_ANY_MAX];
+	k_timepoint_t end = sys_timepoint_calc(timeout);
+
+	while (true) {
+		struct notification *notification;
+		struct sub *sub = sub_take_any(subs, n, &notification);
+		if (sub != NULL) {
+			sub_view_set(view, notification);
+			LOG_DBG("Subscriber %s @ %p served with size %d", sub->name, sub,
+				notification->size);
+			return sub;
+		}
+
+		k_timeout_t remaining = sys_timepoint_timeout(end);
+		if (K_TIMEOUT_EQ(remaining, K_NO_WAIT)) {
+			return NULL;
+		}
+
+		for (size_t i = 0; i < n; i++) {
+			struct k_sem *sem = sub_sem(subs[i]);
+			if (sem != NULL) {
+				k_poll_event_init(&events[i], K_POLL_TYPE_SEM_AVAILABLE,
+						  K_POLL_MODE_NOTIFY_ONLY, sem);
+			} else {
+				k_poll_event_init(&events[i], K_POLL_TYPE_FIFO_DATA_AVAILABLE,
+						  K_POLL_MODE_NOTIFY_ONLY, subs[i]->fifo);
+			}
+		}
+		if (k_poll(events, n, remaining) != 0) {
+			return NULL;
+		}
+	}
+}
+
 void sub_free_internal(struct sub *_sub)
 {
 	if (_sub == NULL) {
 		return;
+	} else if (_sub->pool != NULL) {
+		notification_payload_release(_sub->last_notification->payload);
+		_sub->last_notification = NULL;
 	} else {
 		k_mutex_lock(_sub->mtx, K_FOREVER);
-
-#if defined(CONFIG_ZTEST) && defined(CONFIG_SYS_HEAP_RUNTIME_STATS)
-		struct sys_memory_stats memstat;
-		sys_heap_runtime_stats_get(&_sub->heap->heap, &memstat);
-#endif
-
-		k_heap_free(_sub->heap, _sub->last_notification);
-
-#if defined(CONFIG_ZTEST) && defined(CONFIG_SYS_HEAP_RUNTIME_STATS)
-		struct sys_memory_stats post_memstat;
-		sys_heap_runtime_stats_get(&_sub->heap->heap, &post_memstat);
-		LOG_DBG("%s heap diff after free: %i heap usage: %d bytes of %d total -> %d %%",
-			_sub->name, (int)post_memstat.free_bytes - (int)memstat.free_bytes,
-			post_memstat.allocated_bytes, _sub->heap->heap.init_bytes,
-			(post_memstat.allocated_bytes * 100) / _sub->heap->heap.init_bytes);
-#endif
-
+		notification_payload_release(_sub->last_notification->payload);
 		k_mutex_unlock(_sub->mtx);
 		_sub->last_notification = NULL;
 	}
@@ -210,7 +627,7 @@ int sub_wait_and_receive_internal(struct sub *_sub, const struct pub **_emittor,
 			if (_recv_size) {
 				*_recv_size = sz;
 			}
-			memcpy(_buf, data->data, sz);
+			memcpy(_buf, data->payload->data, sz);
 			if (_emittor) {
 				*_emittor = data->emittor;
 			}
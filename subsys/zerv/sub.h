@@ -15,28 +15,75 @@
 #define _SUB_H_
 
 #include "pub.h"
+#include "sub_ring.h"
+#include "sub_pool.h"
 
 #include <zephyr/kernel.h>
 #include <zephyr/sys/slist.h>
+#include <zephyr/sys/atomic.h>
 #include <stdint.h>
 #include <stddef.h>
 
+/**
+ * @brief The data of a notification, which may be shared by the notifications of several
+ * subscribers.
+ * @note The payload is placed in the same allocation as the notification handles pointing to it
+ * and the allocation is freed when the last reference is dropped.
+ */
+struct notification_payload {
+	atomic_t refcnt;       // Number of notifications still referring to the payload.
+	struct k_heap *heap;   // The heap the allocation was made from, NULL if in a ring.
+	struct sub_ring *ring; // The ring holding the payload, NULL if allocated from a heap.
+	struct sub_pool *pool; // The pool holding the payload, NULL if allocated from a heap.
+	void *block;           // The allocation holding the payload and its notifications.
+	uint8_t data[];
+};
+
+/**
+ * @brief The handle to a notification that is put in the fifo of a subscriber.
+ */
 struct notification {
 	uint32_t unused;
 	const struct pub *emittor; // The publisher that emitted the notification
 	size_t size;
-	uint8_t data[];
-} __aligned(4);
+	struct notification_payload *payload;
+};
+
+// The alignment of the records holding a notification and its payload back-to-back, which is
+// that of the pointers and the atomic_t in them.
+#define SUB_RECORD_ALIGN __alignof__(struct notification_payload)
+
+/**
+ * @brief A zero-copy view of a received notification.
+ */
+struct sub_view {
+	const struct pub *emittor; // The publisher that emitted the notification
+	void *data;
+	size_t size;
+};
 
 struct sub {
-	sys_snode_t node;
 	const char *name;
 	struct k_heap *heap;
 	struct k_fifo *fifo;
-	struct k_mutex *mtx;
+	struct k_mutex *mtx;   // NULL if the subscriber is typed, its msgq has a lock of its own.
+	struct sub_ring *ring; // Replaces the heap and the fifo if the subscriber is ring backed.
+	struct k_msgq *msgq;   // Replaces the heap and the fifo if the subscriber is typed.
+	struct sub_pool *pool; // Replaces the heap and the fifo if the subscriber is lock-free.
 	struct notification *last_notification;
+	uint32_t served;    // When the subscriber was last served by sub_wait_any.
+	atomic_t delivered; // Number of notifications queued to the subscriber.
+	atomic_t dropped;   // Number of notifications lost because the subscriber was full.
 } __aligned(4);
 
+/**
+ * @brief Delivery statistics of a subscriber.
+ */
+struct sub_stats {
+	uint32_t delivered;
+	uint32_t dropped;
+};
+
 /**
  * @brief Macro for defining a subscriber.
  * @param sub_name The name of the subscriber.
@@ -51,9 +98,150 @@ struct sub {
 		.heap = &sub_name##_heap,                                                          \
 		.fifo = &sub_name##_fifo,                                                          \
 		.mtx = &sub_name##_mtx,                                                            \
+		.ring = NULL,                                                                      \
+		.msgq = NULL,                                                                      \
+		.pool = NULL,                                                                      \
+		.last_notification = NULL,                                                         \
+		.served = 0,                                                                       \
+		.delivered = ATOMIC_INIT(0),                                                       \
+		.dropped = ATOMIC_INIT(0),                                                         \
+	};
+
+/**
+ * @brief Macro for defining a subscriber that queues its notifications in a byte ring.
+ *
+ * The notifications are stored back-to-back in one contiguous buffer and freed in the order they
+ * were received, so allocating and freeing them never fragments the queue memory. This suits
+ * subscribers receiving notifications of varying size that are handled in order.
+ *
+ * @param sub_name The name of the subscriber.
+ * @param ring_size The size of the ring in bytes, must be a multiple of SUB_RECORD_ALIGN.
+ *
+ * @note A ring backed subscriber always receives a private copy of the data, also from a
+ * 	 publisher defined with PUB_DEFINE_SHARED.
+ */
+#define SUB_DEFINE_RING(sub_name, ring_size)                                                       \
+	BUILD_ASSERT((ring_size) % SUB_RECORD_ALIGN == 0,                                          \
+		     "The ring size must be a multiple of SUB_RECORD_ALIGN");                      \
+	static uint8_t sub_name##_ring_buf[ring_size] __aligned(SUB_RECORD_ALIGN);                 \
+	static K_SEM_DEFINE(sub_name##_ring_sem, 0, K_SEM_MAX_LIMIT);                              \
+	static struct sub_ring sub_name##_ring = {                                                 \
+		.buf = sub_name##_ring_buf,                                                        \
+		.size = ring_size,                                                                 \
+		.head = 0,                                                                         \
+		.read = 0,                                                                         \
+		.tail = 0,                                                                         \
+		.wrap = 0,                                                                         \
+		.used = 0,                                                                         \
+		.sem = &sub_name##_ring_sem,                                                       \
+	};                                                                                         \
+	static K_MUTEX_DEFINE(sub_name##_mtx);                                                     \
+	struct sub sub_name = {                                                                    \
+		.name = #sub_name,                                                                 \
+		.heap = NULL,                                                                      \
+		.fifo = NULL,                                                                      \
+		.mtx = &sub_name##_mtx,                                                            \
+		.ring = &sub_name##_ring,                                                          \
+		.msgq = NULL,                                                                      \
+		.pool = NULL,                                                                      \
+		.last_notification = NULL,                                                         \
+		.served = 0,                                                                       \
+		.delivered = ATOMIC_INIT(0),                                                       \
+		.dropped = ATOMIC_INIT(0),                                                         \
+	};
+
+/**
+ * @brief Macro for defining a subscriber whose notifications are queued and freed without locks.
+ *
+ * The notifications are copied into a pool of depth fixed-size slots. Allocating a slot, queueing
+ * it, receiving it and freeing it only use atomic operations, so emitting to the subscriber has a
+ * bounded cost and can be done from an ISR.
+ *
+ * @param sub_name The name of the subscriber.
+ * @param max_size The largest notification the subscriber can receive.
+ * @param pool_depth The number of slots, a power of two.
+ *
+ * @note A lock-free subscriber always receives a private copy of the data, also from a publisher
+ * 	 defined with PUB_DEFINE_SHARED. A receiver may have to wait for an emitter it preempted
+ * 	 while it was queueing a notification. It yields to the emitter for a while, and then
+ * 	 sleeps a tick at a time until an emitter of a lower priority has finished.
+ */
+#define SUB_DEFINE_LOCKFREE(sub_name, max_size, pool_depth)                                        \
+	BUILD_ASSERT(IS_POWER_OF_TWO(pool_depth) && (pool_depth) <= 32768,                         \
+		     "The depth must be a power of two of at most 32768");                         \
+	static uint8_t sub_name##_pool_buf[(pool_depth)*SUB_POOL_SLOT_SIZE(max_size)]              \
+		__aligned(SUB_RECORD_ALIGN);                                                       \
+	static atomic_t sub_name##_pool_next[pool_depth];                                          \
+	static atomic_t sub_name##_pool_seq[pool_depth];                                           \
+	static uint32_t sub_name##_pool_cells[pool_depth];                                         \
+	static K_SEM_DEFINE(sub_name##_pool_sem, 0, K_SEM_MAX_LIMIT);                              \
+	static struct sub_pool sub_name##_pool = {                                                 \
+		.buf = sub_name##_pool_buf,                                                        \
+		.slot_size = SUB_POOL_SLOT_SIZE(max_size),                                         \
+		.depth = pool_depth,                                                               \
+		.fresh = ATOMIC_INIT(0),                                                           \
+		.free = ATOMIC_INIT(0),                                                            \
+		.next = sub_name##_pool_next,                                                      \
+		.seq = sub_name##_pool_seq,                                                        \
+		.cells = sub_name##_pool_cells,                                                    \
+		.enq = ATOMIC_INIT(0),                                                             \
+		.deq = ATOMIC_INIT(0),                                                             \
+		.sem = &sub_name##_pool_sem,                                                       \
+	};                                                                                         \
+	static K_MUTEX_DEFINE(sub_name##_mtx);                                                     \
+	struct sub sub_name = {                                                                    \
+		.name = #sub_name,                                                                 \
+		.heap = NULL,                                                                      \
+		.fifo = NULL,                                                                      \
+		.mtx = &sub_name##_mtx,                                                            \
+		.ring = NULL,                                                                      \
+		.msgq = NULL,                                                                      \
+		.pool = &sub_name##_pool,                                                          \
+		.last_notification = NULL,                                                         \
+		.served = 0,                                                                       \
+		.delivered = ATOMIC_INIT(0),                                                       \
+		.dropped = ATOMIC_INIT(0),                                                         \
+	};
+
+/**
+ * @brief Macro for defining a subscriber of fixed-size records of one type.
+ *
+ * The records are copied by value into a message queue holding depth records of exactly
+ * sizeof(type) bytes, without any header or heap allocation. They are received with
+ * SUB_RECEIVE_TYPED, the sub_wait/sub_receive API is not available for typed subscribers.
+ *
+ * @param sub_name The name of the subscriber.
+ * @param type The type of the records.
+ * @param depth The number of records that can be queued.
+ */
+#define SUB_DEFINE_TYPED(sub_name, type, depth)                                                    \
+	BUILD_ASSERT((depth) > 0, "A typed subscriber must be able to queue a record");            \
+	typedef type sub_name##_type_t;                                                            \
+	static K_MSGQ_DEFINE(sub_name##_msgq, sizeof(type), depth, __alignof__(type));             \
+	struct sub sub_name = {                                                                    \
+		.name = #sub_name,                                                                 \
+		.heap = NULL,                                                                      \
+		.fifo = NULL,                                                                      \
+		.mtx = NULL,                                                                       \
+		.ring = NULL,                                                                      \
+		.msgq = &sub_name##_msgq,                                                          \
+		.pool = NULL,                                                                      \
 		.last_notification = NULL,                                                         \
+		.served = 0,                                                                       \
+		.delivered = ATOMIC_INIT(0),                                                       \
+		.dropped = ATOMIC_INIT(0),                                                         \
 	};
 
+/**
+ * @brief Receive a record on a subscriber defined with SUB_DEFINE_TYPED.
+ * @param sub_name The name of the subscriber.
+ * @param value Pointer to store the record in, must point to the type of the subscriber.
+ * @param timeout The timeout for waiting for a record.
+ * @return See sub_receive_typed.
+ */
+#define SUB_RECEIVE_TYPED(sub_name, value, timeout)                                                \
+	sub_receive_typed(&(sub_name), (sub_name##_type_t *){value}, timeout)
+
 /**
  * @brief Macro for defining a subscriber event.
  * @param event_name The name of the event.
@@ -63,6 +251,30 @@ struct sub {
 	K_POLL_EVENT_STATIC_INITIALIZER(K_POLL_TYPE_FIFO_DATA_AVAILABLE, K_POLL_MODE_NOTIFY_ONLY,  \
 					sub_name.fifo, 0)
 
+/**
+ * @brief Macro for defining a subscriber event for a subscriber defined with SUB_DEFINE_TYPED.
+ * @param sub_name The name of the subscriber.
+ */
+#define SUB_TYPED_K_POLL_EVENT_INITIALIZER(sub_name)                                               \
+	K_POLL_EVENT_STATIC_INITIALIZER(K_POLL_TYPE_MSGQ_DATA_AVAILABLE, K_POLL_MODE_NOTIFY_ONLY,  \
+					sub_name.msgq, 0)
+
+/**
+ * @brief Macro for defining a subscriber event for a subscriber defined with SUB_DEFINE_LOCKFREE.
+ * @param sub_name The name of the subscriber.
+ */
+#define SUB_LOCKFREE_K_POLL_EVENT_INITIALIZER(sub_name)                                            \
+	K_POLL_EVENT_STATIC_INITIALIZER(K_POLL_TYPE_SEM_AVAILABLE, K_POLL_MODE_NOTIFY_ONLY,        \
+					sub_name.pool->sem, 0)
+
+/**
+ * @brief Macro for defining a subscriber event for a subscriber defined with SUB_DEFINE_RING.
+ * @param sub_name The name of the subscriber.
+ */
+#define SUB_RING_K_POLL_EVENT_INITIALIZER(sub_name)                                                \
+	K_POLL_EVENT_STATIC_INITIALIZER(K_POLL_TYPE_SEM_AVAILABLE, K_POLL_MODE_NOTIFY_ONLY,        \
+					sub_name.ring->sem, 0)
+
 /**
  * @brief Wait for data from a publisher.
  *
@@ -80,12 +292,17 @@ int sub_wait(struct sub *sub, k_timeout_t timeout);
  * @param[out] recv_size Pointer to the size of the received data.
  *
  * @return Pointer to the received data on success, NULL on failure.
+ *
+ * @note If the publisher is defined with PUB_DEFINE_SHARED the data is shared with the other
+ * subscribers and must not be modified.
  */
 void *sub_receive(struct sub *sub, size_t *recv_size);
 
 /**
  * @brief Free data from a subscriber.
  *
+ * Drops the subscriber's reference to the data, which is freed once no subscriber refers to it.
+ *
  * @param[in] sub_name The name of the subscriber.
  * @param[in] buf The buffer to free.
  *
@@ -93,6 +310,52 @@ void *sub_receive(struct sub *sub, size_t *recv_size);
  */
 void sub_free(struct sub *sub, void *buf);
 
+/**
+ * @brief Receive up to max pending notifications in one operation.
+ *
+ * Waits for the first notification, then takes all other notifications that are already pending
+ * without waiting. The views point into the queue memory of the subscriber, so nothing is copied.
+ *
+ * @param[in] sub The subscriber.
+ * @param[out] views Array receiving a view of each received notification.
+ * @param[in] max The size of the views array.
+ * @param[in] timeout The timeout for waiting for the first notification.
+ *
+ * @return The number of received notifications on success, -EAGAIN if no notification was
+ * received before the timeout, negative error code on failure.
+ *
+ * @note The received notifications must be freed with sub_free_many or sub_free.
+ */
+int sub_receive_many(struct sub *sub, struct sub_view *views, size_t max, k_timeout_t timeout);
+
+/**
+ * @brief Free notifications received with sub_receive_many in one operation.
+ *
+ * @param[in] sub The subscriber.
+ * @param[in] views The views of the notifications to free.
+ * @param[in] cnt The number of views.
+ */
+void sub_free_many(struct sub *sub, const struct sub_view *views, size_t cnt);
+
+/**
+ * @brief Wait for a notification on any of several subscribers.
+ *
+ * When several subscribers have notifications pending, the one that was served the longest ago
+ * by sub_wait_any is picked, so a busy publisher can not starve the others.
+ *
+ * @param[in] subs The subscribers to wait on, at most CONFIG_ZERV_SUB_WAIT_ANY_MAX.
+ * @param[in] n The number of subscribers.
+ * @param[out] view A view of the received notification.
+ * @param[in] timeout The timeout for waiting for a notification.
+ *
+ * @return The subscriber that received the notification, NULL if no notification was received
+ * before the timeout or if the arguments are invalid.
+ *
+ * @note The received notification must be freed with sub_free on the returned subscriber.
+ */
+struct sub *sub_wait_any(struct sub *const subs[], size_t n, struct sub_view *view,
+			 k_timeout_t timeout);
+
 /**
  * @brief Wait for data to be received from a publisher.
  *
@@ -130,4 +393,35 @@ static inline const struct pub *sub_wait_and_receive(struct sub *sub, void *buf,
  */
 int sub_notify(struct sub *sub, struct pub *emittor, const void *_data, size_t _data_size);
 
+/**
+ * @brief Receive a record on a subscriber defined with SUB_DEFINE_TYPED.
+ *
+ * @param[in] sub The subscriber.
+ * @param[out] value Buffer of the size of the records of the subscriber.
+ * @param[in] timeout The timeout for waiting for a record.
+ *
+ * @return 0 on success, -EAGAIN if no record was received before the timeout, -EINVAL if the
+ * subscriber is not typed.
+ */
+int sub_receive_typed(struct sub *sub, void *value, k_timeout_t timeout);
+
+/**
+ * @brief Get the delivery statistics of a subscriber.
+ *
+ * @param[in] sub The subscriber.
+ * @param[out] stats The number of notifications delivered to and dropped by the subscriber.
+ */
+void sub_stats_get(struct sub *sub, struct sub_stats *stats);
+
+/**
+ * @brief Pass a notification allocated by the publisher to a subscriber.
+ *
+ * @param[in] sub The subscriber to receive the notification.
+ * @param[in] notification The notification, referring to a payload shared between subscribers.
+ *
+ * @return 0 on success, negative error code on failure in which case the subscriber's reference
+ * to the payload has been dropped.
+ */
+int sub_notify_shared(struct sub *sub, struct notification *notification);
+
 #endif // _SUB_H_
@@ -0,0 +1,156 @@
+/*=================================================================================================
+ *
+ *           ██████╗ ██╗████████╗███╗   ███╗ █████╗ ███╗   ██╗     █████╗ ██████╗
+ *           ██╔══██╗██║╚══██╔══╝████╗ ████║██╔══██╗████╗  ██║    ██╔══██╗██╔══██╗
+ *           ██████╔╝██║   ██║   ██╔████╔██║███████║██╔██╗ ██║    ███████║██████╔╝
+ *           ██╔══██╗██║   ██║   ██║╚██╔╝██║██╔══██║██║╚██╗██║    ██╔══██║██╔══██╗
+ *           ██████╔╝██║   ██║   ██║ ╚═╝ ██║██║  ██║██║ ╚████║    ██║  ██║██████╔╝
+ *           ╚═════╝ ╚═╝   ╚═╝   ╚═╝     ╚═╝╚═╝  ╚═╝╚═╝  ╚═══╝    ╚═╝  ╚═╝╚═════╝
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * Copyright (c) 2023 BitMan AB
+ * contact: albin@bitman.se
+ *===============================================================================================*/
+#include "sub_pool.h"
+#include "sub.h"
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+
+LOG_MODULE_REGISTER(sub_pool, CONFIG_ZERV_LOG_LEVEL);
+
+#define SUB_POOL_INDEX_MASK 0xFFFF
+#define SUB_POOL_TAG_SHIFT  16
+#define SUB_POOL_YIELD_CNT  16
+
+/**
+ * @brief Make a new top of the free stack, bumping the tag of the previous top.
+ */
+static atomic_val_t sub_pool_top(atomic_val_t prev, uint32_t index_1)
+{
+	uint32_t tag = ((uint32_t)prev >> SUB_POOL_TAG_SHIFT) + 1;
+	return (atomic_val_t)(((tag << SUB_POOL_TAG_SHIFT) & 0xFFFF0000) | index_1);
+}
+
+/**
+ * @brief Take a slot index from the free stack, or a slot never used before.
+ * @return The slot index, -1 if all slots are in use.
+ */
+static int sub_pool_take(struct sub_pool *pool)
+{
+	atomic_val_t top;
+	uint32_t index_1;
+	do {
+		top = atomic_get(&pool->free);
+		index_1 = (uint32_t)top & SUB_POOL_INDEX_MASK;
+		if (index_1 == 0) {
+			break;
+		}
+	} while (!atomic_cas(&pool->free, top,
+			     sub_pool_top(top, (uint32_t)atomic_get(&pool->next[index_1 - 1]))));
+	if (index_1 != 0) {
+		return index_1 - 1;
+	}
+
+	atomic_val_t fresh;
+	do {
+		fresh = atomic_get(&pool->fresh);
+		if ((uint32_t)fresh >= pool->depth) {
+			return -1;
+		}
+	} while (!atomic_cas(&pool->fresh, fresh, fresh + 1));
+	return fresh;
+}
+
+struct notification *sub_pool_alloc(struct sub_pool *pool, size_t data_size)
+{
+	if (SUB_POOL_SLOT_SIZE(data_size) > pool->slot_size) {
+		LOG_ERR("Size %d does not fit in a slot of %d bytes", (int)data_size,
+			(int)pool->slot_size);
+		return NULL;
+	}
+
+	int index = sub_pool_take(pool);
+	if (index < 0) {
+		return NULL;
+	}
+
+	struct notification *notification =
+		(struct notification *)&pool->buf[(size_t)index * pool->slot_size];
+	struct notification_payload *payload = (struct notification_payload *)(notification + 1);
+	atomic_set(&payload->refcnt, 1);
+	payload->heap = NULL;
+	payload->ring = NULL;
+	payload->pool = pool;
+	payload->block = notification;
+	notification->size = data_size;
+	notification->payload = payload;
+	return notification;
+}
+
+void sub_pool_put(struct sub_pool *pool, struct notification *notification)
+{
+	uint32_t index = ((uint8_t *)notification - pool->buf) / pool->slot_size;
+	uint32_t mask = pool->depth - 1;
+	uint32_t pos;
+	uint32_t cell;
+
+	// There is one cell per slot and the slot being queued is not in any cell, so with a single
+	// receiver the cell is always free once its turn has come.
+	while (true) {
+		pos = (uint32_t)atomic_get(&pool->enq);
+		cell = pos & mask;
+		int32_t dif = (int32_t)((uint32_t)atomic_get(&pool->seq[cell]) + cell - pos);
+		if (dif == 0 &&
+		    atomic_cas(&pool->enq, (atomic_val_t)pos, (atomic_val_t)(pos + 1))) {
+			break;
+		}
+	}
+
+	pool->cells[cell] = index;
+	atomic_set(&pool->seq[cell], (atomic_val_t)(pos + 1 - cell));
+}
+
+struct notification *sub_pool_get(struct sub_pool *pool)
+{
+	uint32_t mask = pool->depth - 1;
+	uint32_t pos;
+	uint32_t cell;
+	int yields = 0;
+
+	// The semaphore was taken, so the oldest cell is ready once the emitter queueing it has
+	// finished. An emitter that queued a later cell may have given the semaphore before that,
+	// in which case the emitter of the oldest cell is given time to finish.
+	while (true) {
+		pos = (uint32_t)atomic_get(&pool->deq);
+		cell = pos & mask;
+		int32_t dif = (int32_t)((uint32_t)atomic_get(&pool->seq[cell]) + cell - (pos + 1));
+		if (dif == 0) {
+			if (atomic_cas(&pool->deq, (atomic_val_t)pos, (atomic_val_t)(pos + 1))) {
+				break;
+			}
+		} else if (dif < 0) {
+			// An emitter of the same or a higher priority finishes while the
+			// receiver yields, but one of a lower priority only runs once it sleeps.
+			if (yields < SUB_POOL_YIELD_CNT) {
+				yields++;
+				k_yield();
+			} else {
+				k_sleep(K_TICKS(1));
+			}
+		}
+	}
+
+	uint32_t index = pool->cells[cell];
+	atomic_set(&pool->seq[cell], (atomic_val_t)(pos + mask + 1 - cell));
+	return (struct notification *)&pool->buf[(size_t)index * pool->slot_size];
+}
+
+void sub_pool_free(struct sub_pool *pool, void *block)
+{
+	uint32_t index = ((uint8_t *)block - pool->buf) / pool->slot_size;
+	atomic_val_t top;
+	do {
+		top = atomic_get(&pool->free);
+		atomic_set(&pool->next[index], top & SUB_POOL_INDEX_MASK);
+	} while (!atomic_cas(&pool->free, top, sub_pool_top(top, index + 1)));
+}
@@ -0,0 +1,99 @@
+/*=================================================================================================
+ *
+ *           ██████╗ ██╗████████╗███╗   ███╗ █████╗ ███╗   ██╗     █████╗ ██████╗
+ *           ██╔══██╗██║╚══██╔══╝████╗ ████║██╔══██╗████╗  ██║    ██╔══██╗██╔══██╗
+ *           ██████╔╝██║   ██║   ██╔████╔██║███████║██╔██╗ ██║    ███████║██████╔╝
+ *           ██╔══██╗██║   ██║   ██║╚██╔╝██║██╔══██║██║╚██╗██║    ██╔══██║██╔══██╗
+ *           ██████╔╝██║   ██║   ██║ ╚═╝ ██║██║  ██║██║ ╚████║    ██║  ██║██████╔╝
+ *           ╚═════╝ ╚═╝   ╚═╝   ╚═╝     ╚═╝╚═╝  ╚═╝╚═╝  ╚═══╝    ╚═╝  ╚═╝╚═════╝
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * Copyright (c) 2023 BitMan AB
+ * contact: albin@bitman.se
+ *===============================================================================================*/
+#ifndef _SUB_POOL_H_
+#define _SUB_POOL_H_
+
+#include <zephyr/kernel.h>
+#include <zephyr/sys/atomic.h>
+#include <stdint.h>
+#include <stddef.h>
+
+struct notification; // Forward declaration.
+
+/**
+ * @brief A pool of fixed-size slots holding the notifications of a subscriber, allocated, queued
+ * and freed with atomics only.
+ *
+ * Free slots are kept on a stack whose top is tagged with a counter against the ABA problem, and
+ * slots that have never been used are handed out from a bump counter, so a zero-initialized pool
+ * is ready to use. Filled slots are passed to the receiver through a bounded queue where every
+ * cell carries a sequence number telling if it is free to write or ready to read. The queue has
+ * one cell per slot, so putting an allocated slot in it never fails.
+ *
+ * @note The number of slots must be a power of two and at most 32768. Notifications are expected
+ * 	 to be received by one thread at a time, several emitters may queue concurrently.
+ */
+struct sub_pool {
+	uint8_t *buf;
+	size_t slot_size;  // Bytes per slot, including the notification and the payload headers.
+	uint32_t depth;    // The number of slots.
+	atomic_t fresh;    // The number of slots handed out for the first time.
+	atomic_t free;     // The top of the free stack, a tag in the upper half, index + 1 below.
+	atomic_t *next;    // The index + 1 of the slot below each slot on the free stack.
+	atomic_t *seq;     // The sequence number of each queue cell, relative to the cell index.
+	uint32_t *cells;   // The slot index held by each queue cell.
+	atomic_t enq;      // The position the next slot is queued at.
+	atomic_t deq;      // The position the next slot is received from.
+	struct k_sem *sem; // Counts the slots queued but not yet received.
+};
+
+/**
+ * @brief Get the size of a slot holding notifications with up to data_size bytes of data.
+ * @note The slots are rounded up to SUB_RECORD_ALIGN, so that the atomic reference count of the
+ * payload in every slot is aligned.
+ */
+#define SUB_POOL_SLOT_SIZE(data_size)                                                              \
+	ROUND_UP(sizeof(struct notification) + sizeof(struct notification_payload) + (data_size),  \
+		 SUB_RECORD_ALIGN)
+
+/**
+ * @brief Allocate a slot for a notification.
+ *
+ * @param[in] pool The pool.
+ * @param[in] data_size The size of the notification data.
+ *
+ * @return The notification with its payload set up, NULL if all slots are in use or the data
+ * does not fit in a slot.
+ */
+struct notification *sub_pool_alloc(struct sub_pool *pool, size_t data_size);
+
+/**
+ * @brief Queue an allocated notification to the receiver.
+ *
+ * @param[in] pool The pool.
+ * @param[in] notification The notification.
+ */
+void sub_pool_put(struct sub_pool *pool, struct notification *notification);
+
+/**
+ * @brief Get the oldest queued notification.
+ *
+ * @param[in] pool The pool.
+ *
+ * @return The notification.
+ *
+ * @note Must only be called after taking the pool semaphore, which guarantees that there is a
+ * 	 notification to receive.
+ */
+struct notification *sub_pool_get(struct sub_pool *pool);
+
+/**
+ * @brief Return the slot of a notification to the pool.
+ *
+ * @param[in] pool The pool.
+ * @param[in] block The slot.
+ */
+void sub_pool_free(struct sub_pool *pool, void *block);
+
+#endif // _SUB_POOL_H_
@@ -0,0 +1,118 @@
+/*=================================================================================================
+ *
+ *           ██████╗ ██╗████████╗███╗   ███╗ █████╗ ███╗   ██╗     █████╗ ██████╗
+ *           ██╔══██╗██║╚══██╔══╝████╗ ████║██╔══██╗████╗  ██║    ██╔══██╗██╔══██╗
+ *           ██████╔╝██║   ██║   ██╔████╔██║███████║██╔██╗ ██║    ███████║██████╔╝
+ *           ██╔══██╗██║   ██║   ██║╚██╔╝██║██╔══██║██║╚██╗██║    ██╔══██║██╔══██╗
+ *           ██████╔╝██║   ██║   ██║ ╚═╝ ██║██║  ██║██║ ╚████║    ██║  ██║██████╔╝
+ *           ╚═════╝ ╚═╝   ╚═╝   ╚═╝     ╚═╝╚═╝  ╚═╝╚═╝  ╚═══╝    ╚═╝  ╚═╝╚═════╝
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * Copyright (c) 2023 BitMan AB
+ * contact: albin@bitman.se
+ *===============================================================================================*/
+#include "sub_ring.h"
+#include "sub.h"
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+
+LOG_MODULE_REGISTER(sub_ring, CONFIG_ZERV_LOG_LEVEL);
+
+// The payload follows the notification in a record, so it is aligned if the notification is.
+BUILD_ASSERT(sizeof(struct notification) % SUB_RECORD_ALIGN == 0);
+
+/**
+ * @brief Get the size of the record holding a notification with data_size bytes of data.
+ * @note The records are rounded up to SUB_RECORD_ALIGN, so that every record in the ring starts
+ * aligned for the atomic reference count of its payload.
+ */
+static size_t sub_ring_record_size(size_t data_size)
+{
+	return ROUND_UP(sizeof(struct notification) + sizeof(struct notification_payload) +
+				data_size,
+			SUB_RECORD_ALIGN);
+}
+
+/**
+ * @brief Move an offset to the start of the buffer if it has reached the wrap.
+ */
+static size_t sub_ring_unwrap(const struct sub_ring *ring, size_t offset)
+{
+	return ring->wrap != 0 && offset == ring->wrap ? 0 : offset;
+}
+
+struct notification *sub_ring_alloc(struct sub_ring *ring, size_t data_size)
+{
+	size_t need = sub_ring_record_size(data_size);
+	size_t offset;
+
+	if (ring->used == 0) {
+		// Start over from the beginning of the buffer when the ring is empty, this keeps
+		// the largest possible contiguous space available.
+		ring->head = 0;
+		ring->read = 0;
+		ring->tail = 0;
+		ring->wrap = 0;
+	}
+
+	if (ring->used == 0 || ring->head > ring->tail) {
+		// The free space is from the head to the end and from the start to the tail.
+		if (ring->size - ring->head >= need) {
+			offset = ring->head;
+		} else if (ring->tail >= need) {
+			ring->wrap = ring->head;
+			ring->read = sub_ring_unwrap(ring, ring->read);
+			offset = 0;
+		} else {
+			return NULL;
+		}
+	} else {
+		// The records have wrapped, the free space is from the head to the tail.
+		if (ring->tail - ring->head < need) {
+			return NULL;
+		}
+		offset = ring->head;
+	}
+
+	ring->head = offset + need;
+	ring->used += need;
+
+	struct notification *notification = (struct notification *)&ring->buf[offset];
+	struct notification_payload *payload = (struct notification_payload *)(notification + 1);
+	atomic_set(&payload->refcnt, 1);
+	payload->heap = NULL;
+	payload->ring = ring;
+	payload->pool = NULL;
+	payload->block = notification;
+	notification->size = data_size;
+	notification->payload = payload;
+	return notification;
+}
+
+struct notification *sub_ring_get(struct sub_ring *ring)
+{
+	ring->read = sub_ring_unwrap(ring, ring->read);
+	struct notification *notification = (struct notification *)&ring->buf[ring->read];
+	ring->read = sub_ring_unwrap(ring, ring->read + sub_ring_record_size(notification->size));
+	return notification;
+}
+
+void sub_ring_release(struct sub_ring *ring)
+{
+	while (ring->used > 0) {
+		struct notification *notification = (struct notification *)&ring->buf[ring->tail];
+		if (atomic_get(&notification->payload->refcnt) != 0) {
+			break;
+		}
+
+		size_t record_size = sub_ring_record_size(notification->size);
+		ring->tail += record_size;
+		ring->used -= record_size;
+
+		// Once the tail wraps, the records no longer do.
+		if (ring->wrap != 0 && ring->tail == ring->wrap) {
+			ring->tail = 0;
+			ring->wrap = 0;
+		}
+	}
+}
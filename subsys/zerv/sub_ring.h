@@ -0,0 +1,74 @@
+/*=================================================================================================
+ *
+ *           ██████╗ ██╗████████╗███╗   ███╗ █████╗ ███╗   ██╗     █████╗ ██████╗
+ *           ██╔══██╗██║╚══██╔══╝████╗ ████║██╔══██╗████╗  ██║    ██╔══██╗██╔══██╗
+ *           ██████╔╝██║   ██║   ██╔████╔██║███████║██╔██╗ ██║    ███████║██████╔╝
+ *           ██╔══██╗██║   ██║   ██║╚██╔╝██║██╔══██║██║╚██╗██║    ██╔══██║██╔══██╗
+ *           ██████╔╝██║   ██║   ██║ ╚═╝ ██║██║  ██║██║ ╚████║    ██║  ██║██████╔╝
+ *           ╚═════╝ ╚═╝   ╚═╝   ╚═╝     ╚═╝╚═╝  ╚═╝╚═╝  ╚═══╝    ╚═╝  ╚═╝╚═════╝
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * Copyright (c) 2023 BitMan AB
+ * contact: albin@bitman.se
+ *===============================================================================================*/
+#ifndef _SUB_RING_H_
+#define _SUB_RING_H_
+
+#include <zephyr/kernel.h>
+#include <stdint.h>
+#include <stddef.h>
+
+struct notification; // Forward declaration.
+
+/**
+ * @brief A byte ring storing the notifications of a subscriber back-to-back.
+ *
+ * Records are written at the head and freed from the tail in the order they were written, so
+ * allocating and freeing only moves offsets. A record that does not fit before the end of the
+ * buffer is placed at the start, and the offset where the records wrap is remembered. A record
+ * that is freed out of order is only marked, and its space is reclaimed once all older records
+ * have been freed.
+ *
+ * @note All functions must be called with the subscriber mutex held.
+ */
+struct sub_ring {
+	uint8_t *buf;
+	size_t size;
+	size_t head; // Offset the next record is written to.
+	size_t read; // Offset of the oldest record not yet received.
+	size_t tail; // Offset of the oldest record not yet freed.
+	size_t wrap; // Offset where the records wrap to the start, 0 if they do not wrap.
+	size_t used; // Bytes held by records, not counting the gap at the wrap.
+	struct k_sem *sem; // Counts the records written but not yet received.
+};
+
+/**
+ * @brief Allocate a record for a notification at the head of the ring.
+ *
+ * @param[in] ring The ring.
+ * @param[in] data_size The size of the notification data.
+ *
+ * @return The notification with its payload set up, NULL if the ring is full.
+ */
+struct notification *sub_ring_alloc(struct sub_ring *ring, size_t data_size);
+
+/**
+ * @brief Get the oldest notification in the ring that has not been received yet.
+ *
+ * @param[in] ring The ring.
+ *
+ * @return The notification.
+ *
+ * @note Must only be called after taking the ring semaphore, which guarantees that there is a
+ * 	 notification to receive.
+ */
+struct notification *sub_ring_get(struct sub_ring *ring);
+
+/**
+ * @brief Reclaim the space of the freed records at the tail of the ring.
+ *
+ * @param[in] ring The ring.
+ */
+void sub_ring_release(struct sub_ring *ring);
+
+#endif // _SUB_RING_H_
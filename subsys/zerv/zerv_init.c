@@ -0,0 +1,242 @@
+/*=================================================================================================
+ *
+ *           ██████╗ ██╗████████╗███╗   ███╗ █████╗ ███╗   ██╗     █████╗ ██████╗
+ *           ██╔══██╗██║╚══██╔══╝████╗ ████║██╔══██╗████╗  ██║    ██╔══██╗██╔══██╗
+ *           ██████╔╝██║   ██║   ██╔████╔██║███████║██╔██╗ ██║    ███████║██████╔╝
+ *           ██╔══██╗██║   ██║   ██║╚██╔╝██║██╔══██║██║╚██╗██║    ██╔══██║██╔══██╗
+ *           ██████╔╝██║   ██║   ██║ ╚═╝ ██║██║  ██║██║ ╚████║    ██║  ██║██████╔╝
+ *           ╚═════╝ ╚═╝   ╚═╝   ╚═╝     ╚═╝╚═╝  ╚═╝╚═╝  ╚═══╝    ╚═╝  ╚═╝╚═════╝
+ *
+ * Description:
+ *     Dependency-ordered initialization of zervices at boot.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * Copyright (c) 2023 BitMan AB
+ * contact: albin@bitman.se
+ *=================================================================================================
+ * INCLUDES
+ *===============================================================================================*/
+#include <zephyr/zerv/zerv.h>
+#include <zephyr/zerv/zerv_internal.h>
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+
+/*=================================================================================================
+ * PRIVATE MACROS
+ ================================================================================================*/
+LOG_MODULE_REGISTER(zerv_init, CONFIG_ZERV_LOG_LEVEL);
+
+/*=================================================================================================
+ * PRIVATE DATA
+ ================================================================================================*/
+
+// Guards the done flags of the zervices being initialized, which are signalled on the condvar.
+static K_MUTEX_DEFINE(zerv_init_mtx);
+static K_CONDVAR_DEFINE(zerv_init_cond);
+
+/*=================================================================================================
+ * PRIVATE FUNCTION DEFINITIONS
+ ================================================================================================*/
+
+static bool zerv_init_is_idle(const zervice_t *serv)
+{
+	if (serv->on_enqueue != zerv_internal_lazy_start) {
+		return false;
+	}
+	zerv_lazy_t *lazy = serv->executor;
+	return !atomic_get(&lazy->started);
+}
+
+// Checks if the prerequisites of the record are for the zervice. The records of a sharded
+// zervice are for each of its shards, as the sharded zervice itself is never initialized.
+static bool zerv_init_after_applies(const zerv_init_after_t *after, const zervice_t *serv)
+{
+	if (after->serv == serv) {
+		return true;
+	}
+	if (after->serv->shard_set == NULL) {
+		return false;
+	}
+
+	for (size_t i = 0; i < after->serv->shard_set->instance_cnt; i++) {
+		if (after->serv->shard_set->instances[i] == serv) {
+			return true;
+		}
+	}
+	return false;
+}
+
+// Checks if the zervice is initialized, and starts it if it is a lazy zervice.
+static bool zerv_init_is_done(const zervice_t *serv)
+{
+	if (serv->shard_set != NULL) {
+		for (size_t i = 0; i < serv->shard_set->instance_cnt; i++) {
+			if (!zerv_init_is_done(serv->shard_set->instances[i])) {
+				return false;
+			}
+		}
+		return true;
+	}
+
+	if (serv->on_enqueue == zerv_internal_lazy_start) {
+		zerv_internal_lazy_start(serv);
+	}
+	return atomic_get(&serv->init->done);
+}
+
+// Waits for the zervice to be initialized and returns the return code of its initialization.
+static int zerv_init_wait(const zervice_t *serv)
+{
+	// A sharded zervice is initialized once all of its shards are.
+	if (serv->shard_set != NULL) {
+		for (size_t i = 0; i < serv->shard_set->instance_cnt; i++) {
+			int rc = zerv_init_wait(serv->shard_set->instances[i]);
+			if (rc != 0) {
+				return rc;
+			}
+		}
+		return 0;
+	}
+
+	// Nothing else would start a lazy zervice before its first request.
+	if (serv->on_enqueue == zerv_internal_lazy_start) {
+		zerv_internal_lazy_start(serv);
+	}
+
+	if (!atomic_get(&serv->init->done)) {
+		k_mutex_lock(&zerv_init_mtx, K_FOREVER);
+		while (!atomic_get(&serv->init->done)) {
+			k_condvar_wait(&zerv_init_cond, &zerv_init_mtx, K_FOREVER);
+		}
+		k_mutex_unlock(&zerv_init_mtx);
+	}
+	return serv->init->rc;
+}
+
+/*=================================================================================================
+ * PUBLIC FUNCTION DEFINITIONS
+ ================================================================================================*/
+
+int zerv_internal_init(const zervice_t *serv, int (*init_cb)(void))
+{
+	zerv_init_t *init = serv->init;
+	int rc = 0;
+
+	// A pooled zervice has been waiting since its prerequisites were first checked.
+	if (init->wait_start == 0) {
+		init->wait_start = k_uptime_ticks();
+	}
+	STRUCT_SECTION_FOREACH(zerv_init_after, after)
+	{
+		if (!zerv_init_after_applies(after, serv)) {
+			continue;
+		}
+		for (size_t i = 0; i < after->after_cnt && rc == 0; i++) {
+			LOG_DBG("%s waits for %s", serv->name, after->after[i]->name);
+			if (zerv_init_wait(after->after[i]) != 0) {
+				LOG_ERR("Prerequisite %s of %s failed to initialize",
+					after->after[i]->name, serv->name);
+				rc = ZERV_RC_ERROR;
+			}
+		}
+	}
+
+	init->init_start = k_uptime_ticks();
+	if (rc == 0 && init_cb != NULL) {
+		rc = init_cb();
+	}
+	init->init_end = k_uptime_ticks();
+	init->rc = rc;
+
+	// A failed zervice is marked as done too, so that the zervices waiting for it fail instead
+	// of waiting forever.
+	k_mutex_lock(&zerv_init_mtx, K_FOREVER);
+	atomic_set(&init->done, 1);
+	k_condvar_broadcast(&zerv_init_cond);
+	k_mutex_unlock(&zerv_init_mtx);
+#if defined(CONFIG_ZERV_POOL)
+	zerv_internal_pool_wake();
+#endif
+
+	return rc;
+}
+
+bool zerv_internal_init_ready(const zervice_t *serv)
+{
+	if (serv->init->wait_start == 0) {
+		serv->init->wait_start = k_uptime_ticks();
+	}
+
+	STRUCT_SECTION_FOREACH(zerv_init_after, after)
+	{
+		if (!zerv_init_after_applies(after, serv)) {
+			continue;
+		}
+		for (size_t i = 0; i < after->after_cnt; i++) {
+			if (!zerv_init_is_done(after->after[i])) {
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+zerv_rc_t zerv_wait_ready(k_timeout_t timeout)
+{
+	k_timepoint_t end = sys_timepoint_calc(timeout);
+	zerv_rc_t rc = ZERV_RC_OK;
+
+	k_mutex_lock(&zerv_init_mtx, K_FOREVER);
+	STRUCT_SECTION_FOREACH(zerv_init, init)
+	{
+		if (zerv_init_is_idle(init->serv)) {
+			continue;
+		}
+
+		while (!atomic_get(&init->done)) {
+			k_timeout_t remaining = sys_timepoint_timeout(end);
+			if (K_TIMEOUT_EQ(remaining, K_NO_WAIT)) {
+				LOG_WRN("%s is not initialized in time", init->serv->name);
+				k_mutex_unlock(&zerv_init_mtx);
+				return ZERV_RC_TIMEOUT;
+			}
+			k_condvar_wait(&zerv_init_cond, &zerv_init_mtx, remaining);
+		}
+
+		if (init->rc != 0) {
+			rc = ZERV_RC_ERROR;
+		}
+	}
+	k_mutex_unlock(&zerv_init_mtx);
+
+	return rc;
+}
+
+void zerv_boot_report(void)
+{
+	int64_t boot_end = 0;
+
+	STRUCT_SECTION_FOREACH(zerv_init, init)
+	{
+		if (!atomic_get(&init->done)) {
+			LOG_INF("%s: %s", init->serv->name,
+				zerv_init_is_idle(init->serv) ? "not started" : "initializing");
+			continue;
+		}
+		if (init->init_end == 0) {
+			LOG_INF("%s: ready from boot", init->serv->name);
+			continue;
+		}
+
+		LOG_INF("%s: waited %u us from %u us, initialized in %u us at %u us%s",
+			init->serv->name,
+			(uint32_t)k_ticks_to_us_near64(init->init_start - init->wait_start),
+			(uint32_t)k_ticks_to_us_near64(init->wait_start),
+			(uint32_t)k_ticks_to_us_near64(init->init_end - init->init_start),
+			(uint32_t)k_ticks_to_us_near64(init->init_end),
+			init->rc != 0 ? " (failed)" : "");
+		boot_end = MAX(boot_end, init->init_end);
+	}
+
+	LOG_INF("All zervices initialized at %u us", (uint32_t)k_ticks_to_us_near64(boot_end));
+}
@@ -27,10 +27,176 @@
  ================================================================================================*/
 LOG_MODULE_REGISTER(zerv, CONFIG_ZERV_LOG_LEVEL);
 
+// Set in the state of a zervice lock while a writer holds or waits for it.
+#define ZERV_RWLOCK_WRITER BIT(30)
+// Set in the state of a zervice lock while readers wait for the writer to leave.
+#define ZERV_RWLOCK_WAITING BIT(29)
+#define ZERV_RWLOCK_READERS (ZERV_RWLOCK_WAITING - 1)
+
+// The priority of a request whose caller is not counted by the zervice thread.
+#define ZERV_PRIO_NONE INT_MAX
+
 /*=================================================================================================
  * PRIVATE FUNCTION DECLARATIONS
  ================================================================================================*/
 
+/**
+ * @brief Call a const command directly on the calling thread.
+ */
+static zerv_rc_t zerv_call_const(const zervice_t *serv, zerv_cmd_inst_t *req_instance,
+				 const void *client_req_params, void *resp)
+{
+	LOG_DBG("Calling const %s: %s", serv->name, req_instance->name);
+	zerv_internal_read_lock(serv->rwlock);
+	zerv_rc_t rc = req_instance->handler(client_req_params, resp);
+	zerv_internal_read_unlock(serv->rwlock);
+	return rc;
+}
+
+/**
+ * @brief Pick the zervice to queue a request to, which is the shard given by the key of the request
+ * for a sharded zervice.
+ */
+static const zervice_t *zerv_route(const zervice_t *serv, const void *params, size_t params_len)
+{
+	const zerv_shards_t *shards = serv->shard_set;
+	if (shards == NULL) {
+		return serv;
+	}
+
+	return shards->instances[shards->get_key(params, params_len) % shards->instance_cnt];
+}
+
+/**
+ * @brief Get the lock of a command, which a shard keeps apart from the other shards.
+ */
+static atomic_t *zerv_cmd_lock(const zervice_t *serv, zerv_cmd_inst_t *req_instance)
+{
+	if (serv->cmd_locks == NULL) {
+		return &req_instance->is_locked;
+	}
+
+	return &serv->cmd_locks[req_instance->id - __ZERV_CMD_ID_OFFSET - 1];
+}
+
+/**
+ * @brief Get the lock of a message, which a shard keeps apart from the other shards.
+ */
+static atomic_t *zerv_msg_lock(const zervice_t *serv, zerv_msg_inst_t *msg_instance)
+{
+	if (serv->msg_locks == NULL) {
+		return &msg_instance->is_locked;
+	}
+
+	return &serv->msg_locks[msg_instance->id - __ZERV_MSG_ID_OFFSET - 1];
+}
+
+/**
+ * @brief Lock a command for the duration of a call, unless it is a parallel command that may be
+ * handled for any number of callers at once.
+ */
+static bool zerv_cmd_try_lock(const zervice_t *serv, zerv_cmd_inst_t *req_instance)
+{
+	if (req_instance->kind == ZERV_CMD_KIND_PARALLEL) {
+		return true;
+	}
+
+	// Critical section is used when "locking" the service request as we dont want to
+	// be interrupted by the scheduler while doing this.
+	atomic_t *lock = zerv_cmd_lock(serv, req_instance);
+	k_sched_lock();
+	if (atomic_get(lock)) {
+		k_sched_unlock();
+		return false;
+	}
+	atomic_set(lock, true);
+	k_sched_unlock();
+	return true;
+}
+
+/**
+ * @brief Raise the zervice thread to the priority of the calling thread, which is about to wait on
+ * the request, if that priority is higher than the one the zervice thread runs at.
+ */
+static void zerv_prio_inherit(const zervice_t *serv, zerv_request_t *req)
+{
+	req->prio = ZERV_PRIO_NONE;
+	zerv_prio_t *prio = serv->prio;
+	if (prio == NULL) {
+		return;
+	}
+
+	// The scheduler is locked so that raising the zervice thread does not switch to it while
+	// the spinlock is held.
+	int caller_prio = k_thread_priority_get(k_current_get());
+	k_sched_lock();
+	k_spinlock_key_t key = k_spin_lock(&prio->lock);
+	if (prio->thread != NULL) {
+		req->prio = caller_prio;
+		prio->callers[caller_prio - K_HIGHEST_THREAD_PRIO]++;
+		if (caller_prio < k_thread_priority_get(prio->thread)) {
+			k_thread_priority_set(prio->thread, caller_prio);
+		}
+	}
+	k_spin_unlock(&prio->lock, key);
+	k_sched_unlock();
+}
+
+/**
+ * @brief Stop counting the caller of a request, which is about to be answered.
+ */
+static void zerv_prio_release(const zervice_t *serv, const zerv_request_t *req)
+{
+	zerv_prio_t *prio = serv->prio;
+	if (prio == NULL || req->prio == ZERV_PRIO_NONE) {
+		return;
+	}
+
+	k_spinlock_key_t key = k_spin_lock(&prio->lock);
+	prio->callers[req->prio - K_HIGHEST_THREAD_PRIO]--;
+	k_spin_unlock(&prio->lock, key);
+}
+
+/**
+ * @brief Set the zervice thread to the priority of the highest caller still waiting, or to its
+ * own priority if no caller is waiting.
+ */
+static void zerv_prio_update(const zervice_t *serv)
+{
+	zerv_prio_t *prio = serv->prio;
+	k_spinlock_key_t key = k_spin_lock(&prio->lock);
+	if (prio->thread == k_current_get()) {
+		int next = prio->base;
+		for (int i = 0; i < __ZERV_PRIO_LEVELS; i++) {
+			if (prio->callers[i] != 0) {
+				next = MIN(next, i + K_HIGHEST_THREAD_PRIO);
+				break;
+			}
+		}
+		k_thread_priority_set(prio->thread, next);
+	}
+	k_spin_unlock(&prio->lock, key);
+}
+
+void zerv_internal_enqueue(const zervice_t *serv, zerv_request_t *req)
+{
+	k_fifo_put(serv->fifo, req);
+	if (serv->on_enqueue != NULL) {
+		serv->on_enqueue(serv);
+	}
+}
+
+void zerv_internal_lazy_start(const zervice_t *serv)
+{
+	zerv_lazy_t *lazy = serv->executor;
+	if (!atomic_get(&lazy->started) && atomic_cas(&lazy->started, 0, 1)) {
+		LOG_DBG("Starting lazy %s", serv->name);
+		k_thread_create(lazy->thread, lazy->stack, lazy->stack_bytes,
+				(k_thread_entry_t)__zerv_thread, (void *)serv, lazy->events,
+				(void *)lazy->init_cb, lazy->thread_prio, 0, K_NO_WAIT);
+	}
+}
+
 zerv_rc_t zerv_internal_client_request_handler(const zervice_t *serv, zerv_cmd_inst_t *req_instance,
 					       size_t client_req_params_len,
 					       const void *client_req_params, void *resp,
@@ -39,17 +205,19 @@ zerv_rc_t zerv_internal_client_request_handler(const zervice_t *serv, zerv_cmd_i
 	if (serv == NULL || req_instance == NULL || client_req_params == NULL || resp == NULL) {
 		return ZERV_RC_NULLPTR;
 	}
+	serv = zerv_route(serv, client_req_params, client_req_params_len);
+
+	// A const command has no shared request state, so any number of threads may call it at
+	// once.
+	if (req_instance->kind == ZERV_CMD_KIND_CONST) {
+		return zerv_call_const(serv, req_instance, client_req_params, resp);
+	}
 
 	// Prevent other threads from calling this service request while we are using it.
-	// Critical section is used when "locking" the service request as we dont want to
-	// be interrupted by the scheduler while doing this.
-	k_sched_lock();
-	if (atomic_get(&req_instance->is_locked)) {
-		k_sched_unlock();
+	if (!zerv_cmd_try_lock(serv, req_instance)) {
 		return ZERV_RC_LOCKED;
 	}
-	atomic_set(&req_instance->is_locked, true);
-	k_sched_unlock();
+	atomic_t *lock = zerv_cmd_lock(serv, req_instance);
 
 	LOG_DBG("Calling %s: %s", serv->name, req_instance->name);
 
@@ -60,7 +228,7 @@ zerv_rc_t zerv_internal_client_request_handler(const zervice_t *serv, zerv_cmd_i
 	if (p_req_params == NULL) {
 		LOG_DBG("Failed to allocate request params to %s: %s", serv->name,
 			req_instance->name);
-		atomic_set(&req_instance->is_locked, false);
+		atomic_set(lock, false);
 		return ZERV_RC_NOMEM;
 	}
 	p_req_params->id = req_instance->id;
@@ -72,11 +240,13 @@ zerv_rc_t zerv_internal_client_request_handler(const zervice_t *serv, zerv_cmd_i
 	int rc = k_sem_init(&response_sem, 0, 1);
 	if (rc != 0) {
 		k_heap_free(serv->heap, p_req_params);
-		atomic_set(&req_instance->is_locked, false);
+		atomic_set(lock, false);
 		return ZERV_RC_ERROR;
 	}
 	p_req_params->response_sem = &response_sem;
-	k_fifo_put(serv->fifo, p_req_params);
+	p_req_params->async = NULL;
+	zerv_prio_inherit(serv, p_req_params);
+	zerv_internal_enqueue(serv, p_req_params);
 
 	// Now it's time to let the client thread wait for the response from the service.
 	// TODO: Add timeout. Remember to free the request from the heap and reset the fifo if the
@@ -86,14 +256,14 @@ zerv_rc_t zerv_internal_client_request_handler(const zervice_t *serv, zerv_cmd_i
 	if (rc != 0) {
 		LOG_ERR("Failed to wait for response from %s", serv->name);
 		k_heap_free(serv->heap, p_req_params);
-		atomic_set(&req_instance->is_locked, false);
+		atomic_set(lock, false);
 		return ZERV_RC_TIMEOUT;
 	}
 
 	LOG_DBG("Received response from %s: %s", serv->name, req_instance->name);
 	rc = p_req_params->rc;
 	k_heap_free(serv->heap, p_req_params);
-	atomic_set(&req_instance->is_locked, false);
+	atomic_set(lock, false);
 	return rc;
 }
 
@@ -103,16 +273,18 @@ zerv_rc_t zerv_internal_client_message_handler(const zervice_t *serv, zerv_msg_i
 	if (serv == NULL || msg_instance == NULL || msg_params == NULL) {
 		return ZERV_RC_NULLPTR;
 	}
+	serv = zerv_route(serv, msg_params, msg_params_len);
 
 	// Prevent other threads from passing messages to this service while we are using it.
 	// Critical section is used when "locking" the service request as we dont want to
 	// be interrupted by the scheduler while doing this.
+	atomic_t *lock = zerv_msg_lock(serv, msg_instance);
 	k_sched_lock();
-	if (atomic_get(&msg_instance->is_locked)) {
+	if (atomic_get(lock)) {
 		k_sched_unlock();
 		return ZERV_RC_LOCKED;
 	}
-	atomic_set(&msg_instance->is_locked, true);
+	atomic_set(lock, true);
 	k_sched_unlock();
 
 	LOG_DBG("Sending message %s: %s", serv->name, msg_instance->name);
@@ -124,72 +296,185 @@ zerv_rc_t zerv_internal_client_message_handler(const zervice_t *serv, zerv_msg_i
 	if (p_req_params == NULL) {
 		LOG_DBG("Failed to allocate request params to %s: %s", serv->name,
 			msg_instance->name);
-		atomic_set(&msg_instance->is_locked, false);
+		atomic_set(lock, false);
 		return ZERV_RC_NOMEM;
 	}
 	p_req_params->id = msg_instance->id;
 	p_req_params->client_req_params.data_len = msg_params_len;
 	memcpy(p_req_params->client_req_params.data, msg_params, msg_params_len);
-	k_fifo_put(serv->fifo, p_req_params);
+	p_req_params->async = NULL;
+	zerv_internal_enqueue(serv, p_req_params);
 
 	LOG_DBG("Sent message to %s: %s", serv->name, msg_instance->name);
-	atomic_set(&msg_instance->is_locked, false);
+	atomic_set(lock, false);
 	return ZERV_RC_OK;
 }
 
-zerv_rc_t zerv_internal_emit_topic(sys_slist_t *subscribers, size_t params_size, const void *params)
+zerv_rc_t zerv_internal_async_call(zerv_async_t *async, const zervice_t *serv,
+				   zerv_cmd_inst_t *req_instance, size_t client_req_params_len,
+				   const void *client_req_params, void *resp, size_t resp_len)
 {
-	if (subscribers == NULL || params == NULL) {
+	if (async == NULL || serv == NULL || req_instance == NULL || client_req_params == NULL ||
+	    resp == NULL) {
 		return ZERV_RC_NULLPTR;
 	}
+	serv = zerv_route(serv, client_req_params, client_req_params_len);
+
+	// A const command is handled right away on this thread, so there is nothing to await.
+	if (req_instance->kind == ZERV_CMD_KIND_CONST) {
+		return zerv_call_const(serv, req_instance, client_req_params, resp);
+	}
+
+	if (!zerv_cmd_try_lock(serv, req_instance)) {
+		return ZERV_RC_LOCKED;
+	}
 
-	LOG_DBG("Topic subscriber list: %p", subscribers);
+	LOG_DBG("Calling %s: %s from %s", serv->name, req_instance->name, async->cmd->name);
 
-	sys_snode_t *node = sys_slist_peek_head(subscribers);
-	while (node) {
-		zerv_topic_subscriber_t *subscriber =
-			CONTAINER_OF(node, zerv_topic_subscriber_t, node);
+	// The response is written by the callee right after the parameters, and copied to the
+	// awaiting handler once the request is handed back to its zervice.
+	size_t resp_offset = ROUND_UP(client_req_params_len, sizeof(uint64_t));
+	size_t req_size = sizeof(zerv_request_t) + resp_offset + resp_len;
+	zerv_request_t *p_req_params = k_heap_alloc(serv->heap, req_size, K_NO_WAIT);
+	if (p_req_params == NULL) {
+		LOG_DBG("Failed to allocate request params to %s: %s", serv->name,
+			req_instance->name);
+		atomic_set(zerv_cmd_lock(serv, req_instance), false);
+		return ZERV_RC_NOMEM;
+	}
+	p_req_params->id = req_instance->id;
+	p_req_params->response_sem = NULL;
+	p_req_params->resp_len = resp_len;
+	p_req_params->resp = &p_req_params->client_req_params.data[resp_offset];
+	p_req_params->async = async;
+	p_req_params->client_req_params.data_len = client_req_params_len;
+	memcpy(p_req_params->client_req_params.data, client_req_params, client_req_params_len);
 
-		LOG_DBG("Emitting event to %s on %s", subscriber->msg_instance->name,
-			subscriber->serv->name);
+	async->callee = serv;
+	async->callee_cmd = req_instance;
+	async->resp = resp;
+	zerv_internal_enqueue(serv, p_req_params);
+	return ZERV_RC_FUTURE;
+}
 
-		if (subscriber->msg_instance != NULL && subscriber->serv != NULL) {
-			zerv_rc_t rc = zerv_internal_client_message_handler(
-				subscriber->serv, subscriber->msg_instance, params_size, params);
-			if (rc != ZERV_RC_OK) {
-				LOG_WRN("Failed to emit topic %s on %s (%i) %s",
-					subscriber->msg_instance->name, subscriber->serv->name, rc,
-					strerror(-rc));
+void zerv_internal_read_lock(zerv_rwlock_t *rwlock)
+{
+	while (true) {
+		atomic_val_t state = atomic_get(&rwlock->state);
+		if (!(state & ZERV_RWLOCK_WRITER)) {
+			if (atomic_cas(&rwlock->state, state, state + 1)) {
+				return;
 			}
+			continue;
 		}
 
-		node = sys_slist_peek_next(node);
+		// A writer holds or waits for the lock, wait for it to leave.
+		k_mutex_lock(rwlock->mtx, K_FOREVER);
+		atomic_or(&rwlock->state, ZERV_RWLOCK_WAITING);
+		while (atomic_get(&rwlock->state) & ZERV_RWLOCK_WRITER) {
+			k_condvar_wait(rwlock->cond, rwlock->mtx, K_FOREVER);
+		}
+		k_mutex_unlock(rwlock->mtx);
 	}
+}
 
-	return ZERV_RC_OK;
+void zerv_internal_read_unlock(zerv_rwlock_t *rwlock)
+{
+	atomic_val_t state = atomic_dec(&rwlock->state);
+	if ((state & ZERV_RWLOCK_READERS) == 1 && (state & ZERV_RWLOCK_WRITER)) {
+		// The last reader wakes the waiting writer.
+		k_mutex_lock(rwlock->mtx, K_FOREVER);
+		k_condvar_broadcast(rwlock->cond);
+		k_mutex_unlock(rwlock->mtx);
+	}
 }
 
-/*=================================================================================================
- * PUBLIC FUNCTION DEFINITIONS
- ================================================================================================*/
+void zerv_internal_write_lock(zerv_rwlock_t *rwlock)
+{
+	k_mutex_lock(rwlock->wmtx, K_FOREVER);
 
-zerv_request_t *zerv_get_pending_request(const zervice_t *serv, k_timeout_t timeout)
+	// Setting the writer flag keeps new readers out, then the readers inside are waited for.
+	atomic_val_t state = atomic_or(&rwlock->state, ZERV_RWLOCK_WRITER);
+	if ((state & ZERV_RWLOCK_READERS) == 0) {
+		return;
+	}
+	k_mutex_lock(rwlock->mtx, K_FOREVER);
+	while (atomic_get(&rwlock->state) & ZERV_RWLOCK_READERS) {
+		k_condvar_wait(rwlock->cond, rwlock->mtx, K_FOREVER);
+	}
+	k_mutex_unlock(rwlock->mtx);
+}
+
+void zerv_internal_write_unlock(zerv_rwlock_t *rwlock)
 {
-	if (serv == NULL) {
-		return NULL;
+	atomic_val_t state =
+		atomic_and(&rwlock->state, ~(ZERV_RWLOCK_WRITER | ZERV_RWLOCK_WAITING));
+	if (state & ZERV_RWLOCK_WAITING) {
+		k_mutex_lock(rwlock->mtx, K_FOREVER);
+		k_condvar_broadcast(rwlock->cond);
+		k_mutex_unlock(rwlock->mtx);
 	}
+	k_mutex_unlock(rwlock->wmtx);
+}
 
-	return k_fifo_get(serv->fifo, timeout);
+/**
+ * @brief Pass the return code of a handled command back to its caller.
+ */
+static void zerv_cmd_respond(zerv_request_t *request, zerv_rc_t rc)
+{
+	request->rc = rc;
+	if (request->async != NULL) {
+		// The request is handed back to the zervice awaiting it, which frees it.
+		request->id = __ZERV_RESPONSE_ID;
+		zerv_internal_enqueue(request->async->serv, request);
+	} else {
+		k_sem_give(request->response_sem);
+	}
 }
 
-zerv_rc_t zerv_handle_request(const zervice_t *serv, zerv_request_t *request)
+/**
+ * @brief Run an awaiting command handler until it completes or awaits the next call.
+ */
+static zerv_rc_t zerv_async_step(const zervice_t *serv, zerv_async_t *async)
 {
-	if (serv == NULL || request == NULL) {
-		return ZERV_RC_NULLPTR;
+	zerv_request_t *request = async->req;
+
+	zerv_rc_t rc = async->cmd->async_handler(request->client_req_params.data, request->resp,
+						  async);
+	if (rc == ZERV_RC_FUTURE) {
+		return ZERV_RC_OK;
+	}
+
+	if (rc < ZERV_RC_OK) {
+		LOG_ERR("Failed to handle request on %s", serv->name);
 	}
+	async->req = NULL;
+	async->lc = 0;
+	// The caller is counted until the last step, as it waits through all of them.
+	if (request->async == NULL) {
+		zerv_prio_release(serv, request);
+	}
+	zerv_cmd_respond(request, rc);
+	return rc;
+}
 
+/**
+ * @brief Handle a request with the lock of the zervice already taken.
+ */
+static zerv_rc_t zerv_dispatch_request(const zervice_t *serv, zerv_request_t *request)
+{
 	LOG_DBG("Handling request %d on %s", request->id, serv->name);
 
+	if (request->id == __ZERV_RESPONSE_ID) {
+		// The response to a call awaited by one of the command handlers of the zervice.
+		zerv_async_t *async = request->async;
+		memcpy(async->resp, request->resp, request->resp_len);
+		async->rc = request->rc;
+		k_heap_free(async->callee->heap, request);
+		atomic_set(zerv_cmd_lock(async->callee, async->callee_cmd), false);
+		return zerv_async_step(serv, async);
+	}
+
 	if (request->id < __ZERV_CMD_ID_OFFSET && request->id > __ZERV_MSG_ID_OFFSET) {
 		if (request->id >= serv->cmd_instance_cnt + __ZERV_CMD_ID_OFFSET ||
 		    request->client_req_params.data_len == 0) {
@@ -208,17 +493,28 @@ zerv_rc_t zerv_handle_request(const zervice_t *serv, zerv_request_t *request)
 		return 0;
 	} else if (request->id < __ZERV_TOPIC_MSG_ID_OFFSET && request->id > __ZERV_CMD_ID_OFFSET) {
 		if (request->id >= serv->cmd_instance_cnt + __ZERV_CMD_ID_OFFSET ||
-		    request->response_sem == NULL || request->client_req_params.data_len == 0) {
+		    (request->response_sem == NULL && request->async == NULL) ||
+		    request->client_req_params.data_len == 0) {
 			return ZERV_RC_ERROR;
 		}
 
-		zerv_rc_t rc = serv->cmd_instances[request->id - __ZERV_CMD_ID_OFFSET - 1]->handler(
-			request->client_req_params.data, request->resp);
+		zerv_cmd_inst_t *cmd_inst =
+			serv->cmd_instances[request->id - __ZERV_CMD_ID_OFFSET - 1];
+		if (cmd_inst->async != NULL) {
+			cmd_inst->async->req = request;
+			cmd_inst->async->serv = serv;
+			cmd_inst->async->lc = 0;
+			return zerv_async_step(serv, cmd_inst->async);
+		}
+
+		zerv_rc_t rc = cmd_inst->handler(request->client_req_params.data, request->resp);
 		if (rc < ZERV_RC_OK) {
 			LOG_ERR("Failed to handle request on %s", serv->name);
 		}
-		request->rc = rc;
-		k_sem_give(request->response_sem);
+		if (request->async == NULL) {
+			zerv_prio_release(serv, request);
+		}
+		zerv_cmd_respond(request, rc);
 		return rc;
 	} else if (request->id > __ZERV_TOPIC_MSG_ID_OFFSET) {
 		LOG_DBG("Handling topic message on %s", serv->name);
@@ -228,10 +524,20 @@ zerv_rc_t zerv_handle_request(const zervice_t *serv, zerv_request_t *request)
 			return ZERV_RC_ERROR;
 		}
 
-		zerv_topic_subscriber_t *subscriber =
+		const zerv_topic_subscriber_t *subscriber =
 			serv->topic_subscriber_instances[request->id - __ZERV_TOPIC_MSG_ID_OFFSET -
 							 1];
-		subscriber->msg_instance->handler(request->client_req_params.data);
+		// A request holds one or more events of the topic stored back-to-back.
+		size_t sample_size = subscriber->topic->sample_size;
+		size_t sample_cnt = request->client_req_params.data_len / sample_size;
+		if (subscriber->batch_handler != NULL) {
+			subscriber->batch_handler(request->client_req_params.data, sample_cnt);
+		} else {
+			for (size_t i = 0; i < sample_cnt; i++) {
+				subscriber->msg_instance->handler(
+					&request->client_req_params.data[i * sample_size]);
+			}
+		}
 		k_heap_free(serv->heap, request);
 		return 0;
 	}
@@ -239,6 +545,162 @@ zerv_rc_t zerv_handle_request(const zervice_t *serv, zerv_request_t *request)
 	return ZERV_RC_ERROR;
 }
 
+/**
+ * @brief Check if a request is a call to a parallel command of the zervice.
+ */
+static bool zerv_request_is_parallel(const zervice_t *serv, const zerv_request_t *request)
+{
+	if (request->id <= __ZERV_CMD_ID_OFFSET || request->id >= serv->cmd_instance_cnt) {
+		return false;
+	}
+
+	return serv->cmd_instances[request->id - __ZERV_CMD_ID_OFFSET - 1]->kind ==
+	       ZERV_CMD_KIND_PARALLEL;
+}
+
+/**
+ * @brief Enter the state of the zervice to handle a request. Parallel commands enter as readers,
+ * and all other requests as the only writer. A zervice without a lock is only entered by its
+ * executor.
+ */
+static void zerv_request_lock(const zervice_t *serv, bool parallel)
+{
+	if (serv->rwlock == NULL) {
+		return;
+	} else if (parallel) {
+		zerv_internal_read_lock(serv->rwlock);
+	} else {
+		zerv_internal_write_lock(serv->rwlock);
+	}
+}
+
+static void zerv_request_leave(const zervice_t *serv, bool parallel)
+{
+	if (serv->rwlock == NULL) {
+		return;
+	} else if (parallel) {
+		zerv_internal_read_unlock(serv->rwlock);
+	} else {
+		zerv_internal_write_unlock(serv->rwlock);
+	}
+}
+
+static void zerv_request_unlock(const zervice_t *serv, bool parallel)
+{
+	if (serv->prio == NULL) {
+		zerv_request_leave(serv, parallel);
+		return;
+	}
+
+	// Releasing the mutex of the lock puts the thread back to the priority it locked it at, so
+	// the priority inherited from the callers is set again before any other thread may run.
+	k_sched_lock();
+	zerv_request_leave(serv, parallel);
+	zerv_prio_update(serv);
+	k_sched_unlock();
+}
+
+/*=================================================================================================
+ * PUBLIC FUNCTION DEFINITIONS
+ ================================================================================================*/
+
+zerv_request_t *zerv_get_pending_request(const zervice_t *serv, k_timeout_t timeout)
+{
+	if (serv == NULL) {
+		return NULL;
+	}
+
+	return k_fifo_get(serv->fifo, timeout);
+}
+
+zerv_rc_t zerv_handle_request(const zervice_t *serv, zerv_request_t *request)
+{
+	if (serv == NULL || request == NULL) {
+		return ZERV_RC_NULLPTR;
+	}
+
+	bool parallel = zerv_request_is_parallel(serv, request);
+	zerv_request_lock(serv, parallel);
+	zerv_rc_t rc = zerv_dispatch_request(serv, request);
+	zerv_request_unlock(serv, parallel);
+	return rc;
+}
+
+void zerv_internal_reject_request(const zervice_t *serv, zerv_request_t *request)
+{
+	if (request->id == __ZERV_RESPONSE_ID) {
+		zerv_async_t *async = request->async;
+		k_heap_free(async->callee->heap, request);
+		atomic_set(zerv_cmd_lock(async->callee, async->callee_cmd), false);
+		return;
+	}
+
+	// A caller waits for the response to a command, while the other requests are only freed.
+	if (request->id < __ZERV_TOPIC_MSG_ID_OFFSET && request->id > __ZERV_CMD_ID_OFFSET) {
+		if (request->async == NULL) {
+			zerv_prio_release(serv, request);
+		}
+		zerv_cmd_respond(request, ZERV_RC_ERROR);
+		return;
+	}
+	k_heap_free(serv->heap, request);
+}
+
+int zerv_shard_index(const zervice_t *serv)
+{
+	if (serv == NULL || serv->shard_set == NULL) {
+		return -1;
+	}
+
+	k_tid_t current = k_current_get();
+	for (size_t i = 0; i < serv->shard_set->instance_cnt; i++) {
+		if (*serv->shard_set->tids[i] == current) {
+			return i;
+		}
+	}
+	return -1;
+}
+
+/**
+ * @brief Dispatch a fired event of a zervice thread and make it ready to be polled again.
+ */
+static void zerv_dispatch_event(const zervice_t *p_zervice, zerv_events_t *zervice_events,
+				struct k_poll_event *event, size_t index)
+{
+	if (index == 0) {
+		// Handle the Zervice commands
+		bool fired = event->state == K_POLL_STATE_FIFO_DATA_AVAILABLE;
+		event->state = K_POLL_STATE_NOT_READY;
+		if (!fired) {
+			return;
+		}
+		LOG_DBG("Received request on %s", p_zervice->name);
+		zerv_request_t *p_req_params = k_fifo_get(p_zervice->fifo, K_NO_WAIT);
+		if (p_req_params == NULL) {
+			LOG_ERR("Failed to get request params from %s", p_zervice->name);
+			return;
+		}
+
+		zerv_rc_t rc = zerv_handle_request(p_zervice, p_req_params);
+		if (rc != 0) {
+			LOG_ERR("Failed to handle request on %s", p_zervice->name);
+		}
+		return;
+	}
+
+	// Handle the Zervice events
+	LOG_DBG("Received event on %s", p_zervice->name);
+	if (event->state == event->type) {
+		zerv_request_lock(p_zervice, false);
+		zervice_events->events[index]->handler(event->obj);
+		zerv_request_unlock(p_zervice, false);
+	}
+	if (event->type == K_POLL_TYPE_SIGNAL) {
+		k_poll_signal_reset(event->signal);
+	}
+	event->state = K_POLL_STATE_NOT_READY;
+}
+
 void __zerv_thread(const zervice_t *p_zervice, zerv_events_t *zervice_events,
 		   int (*on_init_cb)(void))
 {
@@ -252,15 +714,6 @@ void __zerv_thread(const zervice_t *p_zervice, zerv_events_t *zervice_events,
 	}
 
 	LOG_DBG("Starting %s", p_zervice->name);
-	for (size_t i = 0; i < p_zervice->topic_subscribers_cnt; i++) {
-		LOG_DBG("i = %d", i);
-		LOG_DBG("Adding %d subscribers to topic", p_zervice->topic_subscribers_cnt);
-		sys_slist_t *topic_subscriber_list = p_zervice->topic_subscriber_lists[i];
-		LOG_DBG("Topic subscriber list: %p", topic_subscriber_list);
-		zerv_topic_subscriber_t *sub = p_zervice->topic_subscriber_instances[i];
-		LOG_DBG("Adding subscriber %s", sub->msg_instance->name);
-		sys_slist_append(topic_subscriber_list, &sub->node);
-	}
 
 	LOG_DBG("Starting event processor for %s, num events %d", p_zervice->name,
 		zervice_events->event_cnt);
@@ -279,12 +732,17 @@ void __zerv_thread(const zervice_t *p_zervice, zerv_events_t *zervice_events,
 		events[i].state = K_POLL_STATE_NOT_READY;
 	}
 
-	if (on_init_cb) {
-		int rc = on_init_cb();
-		if (rc != 0) {
-			LOG_ERR("Failed to initialize %s", p_zervice->name);
-			return;
-		}
+	if (zerv_internal_init(p_zervice, on_init_cb) != 0) {
+		LOG_ERR("Failed to initialize %s", p_zervice->name);
+		return;
+	}
+
+	// The callers are only counted from here on, as the thread now waits on the requests.
+	if (p_zervice->prio != NULL) {
+		k_spinlock_key_t key = k_spin_lock(&p_zervice->prio->lock);
+		p_zervice->prio->base = k_thread_priority_get(k_current_get());
+		p_zervice->prio->thread = k_current_get();
+		k_spin_unlock(&p_zervice->prio->lock, key);
 	}
 
 	while (true) {
@@ -294,33 +752,55 @@ void __zerv_thread(const zervice_t *p_zervice, zerv_events_t *zervice_events,
 			continue;
 		}
 
-		// Handle the Zervice commands first
-		if (events[0].state == K_POLL_TYPE_FIFO_DATA_AVAILABLE) {
-			events[0].state = K_POLL_STATE_NOT_READY;
-			LOG_DBG("Received request on %s", p_zervice->name);
-			zerv_request_t *p_req_params = k_fifo_get(p_zervice->fifo, K_NO_WAIT);
-			if (p_req_params == NULL) {
-				LOG_ERR("Failed to get request params from %s", p_zervice->name);
-				continue;
+		// Only the events that fired are dispatched and reset. The request fifo is the
+		// first event, so the requests are dispatched before the other events.
+		for (size_t i = 0; i < zervice_events->event_cnt; i++) {
+			if (events[i].state != K_POLL_STATE_NOT_READY) {
+				zerv_dispatch_event(p_zervice, zervice_events, &events[i], i);
 			}
+		}
+	}
+}
 
-			zerv_rc_t rc = zerv_handle_request(p_zervice, p_req_params);
-			if (rc != 0) {
-				LOG_ERR("Failed to handle request on %s", p_zervice->name);
-				continue;
-			}
+void __zerv_replica_thread(const zervice_t *p_zervice, zerv_replicas_t *replicas, size_t index)
+{
+	if (p_zervice == NULL || replicas == NULL) {
+		return;
+	}
+
+	// The first replica initializes the zervice before any replica takes a request.
+	if (index == 0) {
+		if (zerv_internal_init(p_zervice, replicas->init_cb) != 0) {
+			LOG_ERR("Failed to initialize %s", p_zervice->name);
+			return;
 		}
+		for (size_t i = 1; i < replicas->worker_cnt; i++) {
+			k_sem_give(replicas->ready);
+		}
+	} else {
+		k_sem_take(replicas->ready, K_FOREVER);
+	}
 
-		// Handle the Zervice events
-		LOG_DBG("Received event on %s", p_zervice->name);
-		for (size_t i = 1; i < zervice_events->event_cnt; i++) {
-			if (events[i].state == events[i].type) {
-				zervice_events->events[i]->handler(events[i].obj);
-			}
-			if (events[i].type == K_POLL_TYPE_SIGNAL) {
-				k_poll_signal_reset(events[i].signal);
-			}
-			events[i].state = K_POLL_STATE_NOT_READY;
+	LOG_DBG("Starting replica %d of %s", (int)index, p_zervice->name);
+
+	while (true) {
+		// The lock of a request is taken before the next replica may take a request, so the
+		// requests enter the zervice in the order they were queued. An exclusive request
+		// waits for the parallel ones before it, and holds back the ones after it.
+		k_mutex_lock(replicas->dispatch, K_FOREVER);
+		zerv_request_t *p_req_params = k_fifo_get(p_zervice->fifo, K_FOREVER);
+		if (p_req_params == NULL) {
+			k_mutex_unlock(replicas->dispatch);
+			continue;
+		}
+		bool parallel = zerv_request_is_parallel(p_zervice, p_req_params);
+		zerv_request_lock(p_zervice, parallel);
+		k_mutex_unlock(replicas->dispatch);
+
+		zerv_rc_t rc = zerv_dispatch_request(p_zervice, p_req_params);
+		zerv_request_unlock(p_zervice, parallel);
+		if (rc != 0) {
+			LOG_ERR("Failed to handle request on %s", p_zervice->name);
 		}
 	}
 }
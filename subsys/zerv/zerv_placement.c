@@ -0,0 +1,117 @@
+/*=================================================================================================
+ *
+ *           ██████╗ ██╗████████╗███╗   ███╗ █████╗ ███╗   ██╗     █████╗ ██████╗
+ *           ██╔══██╗██║╚══██╔══╝████╗ ████║██╔══██╗████╗  ██║    ██╔══██╗██╔══██╗
+ *           ██████╔╝██║   ██║   ██╔████╔██║███████║██╔██╗ ██║    ███████║██████╔╝
+ *           ██╔══██╗██║   ██║   ██║╚██╔╝██║██╔══██║██║╚██╗██║    ██╔══██║██╔══██╗
+ *           ██████╔╝██║   ██║   ██║ ╚═╝ ██║██║  ██║██║ ╚████║    ██║  ██║██████╔╝
+ *           ╚═════╝ ╚═╝   ╚═╝   ╚═╝     ╚═╝╚═╝  ╚═╝╚═╝  ╚═══╝    ╚═╝  ╚═╝╚═════╝
+ *
+ * Description:
+ *     Placement of the zervice threads on the CPUs of SMP targets.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * Copyright (c) 2023 BitMan AB
+ * contact: albin@bitman.se
+ *=================================================================================================
+ * INCLUDES
+ *===============================================================================================*/
+#include <zephyr/zerv/zerv.h>
+#include <zephyr/zerv/zerv_internal.h>
+#include <zephyr/kernel.h>
+#include <zephyr/init.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/sys/iterable_sections.h>
+
+/*=================================================================================================
+ * PRIVATE MACROS
+ ================================================================================================*/
+LOG_MODULE_REGISTER(zerv_placement, CONFIG_ZERV_LOG_LEVEL);
+
+/*=================================================================================================
+ * PRIVATE FUNCTION DECLARATIONS
+ ================================================================================================*/
+static void zerv_placement_thread(void *p1, void *p2, void *p3);
+
+/*=================================================================================================
+ * PRIVATE VARIABLES
+ ================================================================================================*/
+
+// Static threads are created after the last init level, so the placed zervice threads are defined
+// as not started and placed by this thread, which is started once all of them exist. It runs at
+// the highest cooperative priority below the meta-IRQ priorities, which K_PRIO_COOP(0) may be.
+K_THREAD_DEFINE(zerv_placement_tid, CONFIG_ZERV_PLACEMENT_STACK_SIZE, zerv_placement_thread, NULL,
+		NULL, NULL, K_PRIO_COOP(CONFIG_NUM_METAIRQ_PRIORITIES), 0, 0);
+
+/*=================================================================================================
+ * PRIVATE FUNCTION DEFINITIONS
+ ================================================================================================*/
+
+static uint32_t zerv_placement_rt_mask(void)
+{
+#if CONFIG_ZERV_RT_CPU >= 0
+	return BIT(CONFIG_ZERV_RT_CPU) & BIT_MASK(arch_num_cpus());
+#else
+	return 0;
+#endif
+}
+
+static void zerv_placement_thread(void *p1, void *p2, void *p3)
+{
+	ARG_UNUSED(p1);
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	STRUCT_SECTION_FOREACH(zerv_placement, placement) {
+		k_tid_t tid = *placement->tid;
+		uint32_t mask = zerv_internal_placement_resolve(placement->placement);
+
+		int rc = k_thread_cpu_mask_clear(tid);
+		for (unsigned int cpu = 0; rc == 0 && cpu < arch_num_cpus(); cpu++) {
+			if (mask & BIT(cpu)) {
+				rc = k_thread_cpu_mask_enable(tid, cpu);
+			}
+		}
+		if (rc != 0) {
+			LOG_ERR("Failed to place %s on CPUs 0x%x (%d)", placement->serv->name, mask,
+				rc);
+			k_thread_cpu_mask_enable_all(tid);
+		}
+
+		LOG_DBG("Starting %s on CPUs 0x%x", placement->serv->name, mask);
+		k_thread_start(tid);
+	}
+}
+
+/*=================================================================================================
+ * PUBLIC FUNCTION DEFINITIONS
+ ================================================================================================*/
+
+uint32_t zerv_internal_placement_resolve(uint32_t placement)
+{
+	uint32_t all = BIT_MASK(arch_num_cpus());
+	uint32_t rt = zerv_placement_rt_mask();
+	// On a target with the real-time CPU as the only CPU, everything has to share it.
+	uint32_t shared = (all & ~rt) != 0 ? all & ~rt : all;
+
+	if (placement & __ZERV_PLACEMENT_RT) {
+		if (rt == 0) {
+			LOG_WRN("No real-time CPU, set CONFIG_ZERV_RT_CPU");
+			return shared;
+		}
+		return rt;
+	}
+
+	if (placement & __ZERV_PLACEMENT_GROUP) {
+		// The groups are dealt out round-robin over the shared CPUs.
+		uint32_t index = (placement & ~__ZERV_PLACEMENT_GROUP) % __builtin_popcount(shared);
+		for (unsigned int cpu = 0; cpu < arch_num_cpus(); cpu++) {
+			if ((shared & BIT(cpu)) && index-- == 0) {
+				return BIT(cpu);
+			}
+		}
+	}
+
+	uint32_t mask = placement & all;
+	return mask != 0 ? mask : shared;
+}
@@ -0,0 +1,166 @@
+/*=================================================================================================
+ *
+ *           ██████╗ ██╗████████╗███╗   ███╗ █████╗ ███╗   ██╗     █████╗ ██████╗
+ *           ██╔══██╗██║╚══██╔══╝████╗ ████║██╔══██╗████╗  ██║    ██╔══██╗██╔══██╗
+ *           ██████╔╝██║   ██║   ██╔████╔██║███████║██╔██╗ ██║    ███████║██████╔╝
+ *           ██╔══██╗██║   ██║   ██║╚██╔╝██║██╔══██║██║╚██╗██║    ██╔══██║██╔══██╗
+ *           ██████╔╝██║   ██║   ██║ ╚═╝ ██║██║  ██║██║ ╚████║    ██║  ██║██████╔╝
+ *           ╚═════╝ ╚═╝   ╚═╝   ╚═╝     ╚═╝╚═╝  ╚═╝╚═╝  ╚═══╝    ╚═╝  ╚═╝╚═════╝
+ *
+ * Description:
+ *     Shared worker threads running the pooled zervices as actors.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * Copyright (c) 2023 BitMan AB
+ * contact: albin@bitman.se
+ *=================================================================================================
+ * INCLUDES
+ *===============================================================================================*/
+#include <zephyr/zerv/zerv.h>
+#include <zephyr/zerv/zerv_internal.h>
+#include <zephyr/kernel.h>
+#include <zephyr/init.h>
+#include <zephyr/logging/log.h>
+
+/*=================================================================================================
+ * PRIVATE MACROS
+ ================================================================================================*/
+LOG_MODULE_REGISTER(zerv_pool, CONFIG_ZERV_LOG_LEVEL);
+
+/*=================================================================================================
+ * PRIVATE FUNCTION DECLARATIONS
+ ================================================================================================*/
+static void zerv_pool_worker(void *p1, void *p2, void *p3);
+static void zerv_pool_run(zerv_actor_t *actor);
+static void zerv_pool_unpark(void);
+
+/*=================================================================================================
+ * PRIVATE VARIABLES
+ ================================================================================================*/
+
+// The actors with queued requests, in the order they became ready. All workers take from the same
+// queue, so an idle worker picks up the next ready zervice no matter which worker ran it before.
+static K_FIFO_DEFINE(zerv_pool_run_queue);
+
+// The actors waiting for their prerequisites to be initialized, which are queued to run again each
+// time a zervice has been initialized. The count of those wakeups lets an actor that is parked
+// just as a zervice is initialized see that it missed the wakeup.
+static K_FIFO_DEFINE(zerv_pool_parked);
+static atomic_t zerv_pool_wake_cnt;
+
+static K_THREAD_STACK_ARRAY_DEFINE(zerv_pool_stacks, CONFIG_ZERV_POOL_WORKERS,
+				   CONFIG_ZERV_POOL_STACK_SIZE);
+static struct k_thread zerv_pool_threads[CONFIG_ZERV_POOL_WORKERS];
+
+/*=================================================================================================
+ * PRIVATE FUNCTION DEFINITIONS
+ ================================================================================================*/
+
+static void zerv_pool_worker(void *p1, void *p2, void *p3)
+{
+	ARG_UNUSED(p1);
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	while (true) {
+		zerv_actor_t *actor = k_fifo_get(&zerv_pool_run_queue, K_FOREVER);
+		if (actor == NULL) {
+			continue;
+		}
+
+		zerv_pool_run(actor);
+	}
+}
+
+static void zerv_pool_unpark(void)
+{
+	zerv_actor_t *actor;
+	while ((actor = k_fifo_get(&zerv_pool_parked, K_NO_WAIT)) != NULL) {
+		k_fifo_put(&zerv_pool_run_queue, actor);
+	}
+}
+
+static void zerv_pool_run(zerv_actor_t *actor)
+{
+	const zervice_t *serv = actor->serv;
+
+	if (atomic_get(&actor->init_pending)) {
+		// A worker never waits for the prerequisites, as they may be pooled zervices that
+		// need a worker themselves. The actor stays scheduled while it is parked.
+		atomic_val_t wake_cnt = atomic_get(&zerv_pool_wake_cnt);
+		if (!zerv_internal_init_ready(serv)) {
+			k_fifo_put(&zerv_pool_parked, actor);
+			if (atomic_get(&zerv_pool_wake_cnt) != wake_cnt) {
+				zerv_pool_unpark();
+			}
+			return;
+		}
+
+		atomic_clear(&actor->init_pending);
+		if (zerv_internal_init(serv, actor->init_cb) != 0) {
+			LOG_ERR("Failed to initialize %s", serv->name);
+		}
+	}
+
+	if (serv->init->rc != 0) {
+		// A zervice that failed to initialize never handles a request, so its requests are
+		// rejected rather than left queued with their callers waiting for them.
+		zerv_request_t *req;
+		while ((req = k_fifo_get(serv->fifo, K_NO_WAIT)) != NULL) {
+			zerv_internal_reject_request(serv, req);
+		}
+	}
+
+	// Only a bounded batch of requests is handled per turn, so that a busy zervice can not keep
+	// the worker from the zervices queued behind it.
+	for (int i = 0; i < CONFIG_ZERV_POOL_BATCH; i++) {
+		zerv_request_t *req = k_fifo_get(serv->fifo, K_NO_WAIT);
+		if (req == NULL) {
+			break;
+		}
+
+		zerv_rc_t rc = zerv_handle_request(serv, req);
+		if (rc != 0) {
+			LOG_ERR("Failed to handle request on %s", serv->name);
+		}
+	}
+
+	// A request queued since the last get found the actor still scheduled and did not queue it,
+	// so the fifo is checked again once the actor has been released.
+	atomic_clear(&actor->scheduled);
+	__atomic_thread_fence(__ATOMIC_SEQ_CST);
+	if (!k_fifo_is_empty(serv->fifo)) {
+		zerv_internal_pool_schedule(serv);
+	}
+}
+
+static int zerv_pool_init(void)
+{
+	for (int i = 0; i < CONFIG_ZERV_POOL_WORKERS; i++) {
+		k_thread_create(&zerv_pool_threads[i], zerv_pool_stacks[i],
+				K_THREAD_STACK_SIZEOF(zerv_pool_stacks[i]), zerv_pool_worker, NULL,
+				NULL, NULL, CONFIG_ZERV_POOL_PRIORITY, 0, K_NO_WAIT);
+	}
+	return 0;
+}
+
+SYS_INIT(zerv_pool_init, APPLICATION, 0);
+
+/*=================================================================================================
+ * PUBLIC FUNCTION DEFINITIONS
+ ================================================================================================*/
+
+void zerv_internal_pool_wake(void)
+{
+	atomic_inc(&zerv_pool_wake_cnt);
+	zerv_pool_unpark();
+}
+
+void zerv_internal_pool_schedule(const zervice_t *serv)
+{
+	zerv_actor_t *actor = serv->executor;
+
+	if (atomic_cas(&actor->scheduled, 0, 1)) {
+		k_fifo_put(&zerv_pool_run_queue, actor);
+	}
+}
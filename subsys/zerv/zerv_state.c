@@ -0,0 +1,73 @@
+/*=================================================================================================
+ *
+ *           ██████╗ ██╗████████╗███╗   ███╗ █████╗ ███╗   ██╗     █████╗ ██████╗
+ *           ██╔══██╗██║╚══██╔══╝████╗ ████║██╔══██╗████╗  ██║    ██╔══██╗██╔══██╗
+ *           ██████╔╝██║   ██║   ██╔████╔██║███████║██╔██╗ ██║    ███████║██████╔╝
+ *           ██╔══██╗██║   ██║   ██║╚██╔╝██║██╔══██║██║╚██╗██║    ██╔══██║██╔══██╗
+ *           ██████╔╝██║   ██║   ██║ ╚═╝ ██║██║  ██║██║ ╚████║    ██║  ██║██████╔╝
+ *           ╚═════╝ ╚═╝   ╚═╝   ╚═╝     ╚═╝╚═╝  ╚═╝╚═╝  ╚═══╝    ╚═╝  ╚═╝╚═════╝
+ *
+ * Description:
+ *     Sequence locked state objects owned by zervices.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * Copyright (c) 2023 BitMan AB
+ * contact: albin@bitman.se
+ *=================================================================================================
+ * INCLUDES
+ *===============================================================================================*/
+#include <zephyr/zerv/zerv_internal.h>
+#include <zephyr/kernel.h>
+#include <zephyr/spinlock.h>
+#include <zephyr/logging/log.h>
+#include <string.h>
+
+/*=================================================================================================
+ * PRIVATE MACROS
+ ================================================================================================*/
+LOG_MODULE_REGISTER(zerv_state, CONFIG_ZERV_LOG_LEVEL);
+
+/*=================================================================================================
+ * PUBLIC FUNCTION DEFINITIONS
+ ================================================================================================*/
+
+zerv_rc_t zerv_internal_state_publish(zerv_state_t *state, const void *value)
+{
+	if (state == NULL || value == NULL) {
+		return ZERV_RC_NULLPTR;
+	}
+
+	// The writer can not be preempted while the sequence is odd, so a reader on the same CPU
+	// never has to wait for it.
+	k_spinlock_key_t key = k_spin_lock(state->lock);
+	atomic_inc(&state->seq);
+	__atomic_thread_fence(__ATOMIC_SEQ_CST);
+	memcpy(state->data, value, state->size);
+	__atomic_thread_fence(__ATOMIC_SEQ_CST);
+	atomic_inc(&state->seq);
+	k_spin_unlock(state->lock, key);
+
+	LOG_DBG("Published %s of %s", state->name, state->owner->name);
+	return ZERV_RC_OK;
+}
+
+zerv_rc_t zerv_internal_state_read(zerv_state_t *state, void *value)
+{
+	if (state == NULL || value == NULL) {
+		return ZERV_RC_NULLPTR;
+	}
+
+	atomic_val_t seq;
+	do {
+		seq = atomic_get(&state->seq);
+		if (seq & 1) {
+			// An update is being written on another CPU.
+			continue;
+		}
+		__atomic_thread_fence(__ATOMIC_SEQ_CST);
+		memcpy(value, state->data, state->size);
+		__atomic_thread_fence(__ATOMIC_SEQ_CST);
+	} while ((seq & 1) || atomic_get(&state->seq) != seq);
+
+	return ZERV_RC_OK;
+}
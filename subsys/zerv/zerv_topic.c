@@ -0,0 +1,268 @@
+/*=================================================================================================
+ *
+ *           ██████╗ ██╗████████╗███╗   ███╗ █████╗ ███╗   ██╗     █████╗ ██████╗
+ *           ██╔══██╗██║╚══██╔══╝████╗ ████║██╔══██╗████╗  ██║    ██╔══██╗██╔══██╗
+ *           ██████╔╝██║   ██║   ██╔████╔██║███████║██╔██╗ ██║    ███████║██████╔╝
+ *           ██╔══██╗██║   ██║   ██║╚██╔╝██║██╔══██║██║╚██╗██║    ██╔══██║██╔══██╗
+ *           ██████╔╝██║   ██║   ██║ ╚═╝ ██║██║  ██║██║ ╚████║    ██║  ██║██████╔╝
+ *           ╚═════╝ ╚═╝   ╚═╝   ╚═╝     ╚═╝╚═╝  ╚═╝╚═╝  ╚═══╝    ╚═╝  ╚═╝╚═════╝
+ *
+ * Description:
+ *     Topic subscriber tables and topic emission.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * Copyright (c) 2023 BitMan AB
+ * contact: albin@bitman.se
+ *=================================================================================================
+ * INCLUDES
+ *===============================================================================================*/
+#include <zephyr/zerv/zerv_internal.h>
+#include <zephyr/kernel.h>
+#include <zephyr/init.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/sys/iterable_sections.h>
+#include <string.h>
+
+/*=================================================================================================
+ * PRIVATE MACROS
+ ================================================================================================*/
+LOG_MODULE_REGISTER(zerv_topic, CONFIG_ZERV_LOG_LEVEL);
+
+/*=================================================================================================
+ * PRIVATE VARIABLES
+ ================================================================================================*/
+
+// Storage for the pattern match tables of all topics, each topic owns one contiguous slice.
+static zerv_topic_t *zerv_topic_matches[CONFIG_ZERV_TOPIC_PATTERN_MATCHES];
+
+/*=================================================================================================
+ * PRIVATE FUNCTION DEFINITIONS
+ ================================================================================================*/
+
+/**
+ * @brief Check if a topic path matches a pattern, level by level.
+ *
+ * A '+' level matches any single level and a trailing '#' level matches all remaining levels,
+ * including none.
+ */
+static bool zerv_topic_path_matches(const char *pattern, const char *path)
+{
+	while (true) {
+		if (pattern[0] == '#' && pattern[1] == '\0') {
+			return true;
+		}
+
+		if (pattern[0] == '+' && (pattern[1] == '/' || pattern[1] == '\0')) {
+			pattern++;
+			while (*path != '/' && *path != '\0') {
+				path++;
+			}
+		} else {
+			while (*pattern != '/' && *pattern != '\0') {
+				if (*pattern++ != *path++) {
+					return false;
+				}
+			}
+			if (*path != '/' && *path != '\0') {
+				return false;
+			}
+		}
+
+		// Both the pattern and the path are at the end of a level here.
+		if (*pattern == '\0') {
+			return *path == '\0';
+		}
+		if (*path == '\0') {
+			return strcmp(pattern, "/#") == 0;
+		}
+		pattern++;
+		path++;
+	}
+}
+
+/**
+ * @brief Resolve the subscriber table and the pattern match table of every topic.
+ *
+ * The subscribers are sorted by topic in the iterable section, so each topic is given a pointer
+ * to its first subscriber and the number of adjacent subscribers. Every topic is then matched
+ * against every pattern that has subscribers, so that emission never has to match paths. This
+ * runs before any zervice thread is started, so no early emission can miss a subscriber.
+ */
+static int zerv_topic_init(void)
+{
+	zerv_topic_t *topic = NULL;
+
+	STRUCT_SECTION_FOREACH(zerv_topic_subscriber, subscriber) {
+		if (subscriber->topic != topic) {
+			topic = subscriber->topic;
+			__ASSERT(topic->subscribers == NULL,
+				 "Subscribers of topic %s are not contiguous", topic->name);
+			topic->subscribers = subscriber;
+			topic->subscriber_cnt = 0;
+		}
+		topic->subscriber_cnt++;
+	}
+
+	size_t match_cnt = 0;
+	STRUCT_SECTION_FOREACH(zerv_topic, topic) {
+		if (topic->is_pattern) {
+			continue;
+		}
+
+		size_t first = MIN(match_cnt, ARRAY_SIZE(zerv_topic_matches));
+		topic->matches = &zerv_topic_matches[first];
+		topic->match_cnt = 0;
+		STRUCT_SECTION_FOREACH(zerv_topic, pattern) {
+			if (!pattern->is_pattern || pattern->subscriber_cnt == 0 ||
+			    !zerv_topic_path_matches(pattern->path, topic->path)) {
+				continue;
+			}
+			if (pattern->sample_size != topic->sample_size) {
+				LOG_ERR("Topic %s and pattern %s have different parameters, the "
+					"pattern is not matched",
+					topic->name, pattern->name);
+				continue;
+			}
+			// The matches are counted past the end of the table, so that the error
+			// below can tell the size needed.
+			if (match_cnt < ARRAY_SIZE(zerv_topic_matches)) {
+				zerv_topic_matches[match_cnt] = pattern;
+				topic->match_cnt++;
+			}
+			match_cnt++;
+		}
+	}
+
+	// A partial match table would silently drop events, so the boot is stopped instead.
+	if (match_cnt > ARRAY_SIZE(zerv_topic_matches)) {
+		LOG_ERR("The topics have %d pattern matches, set "
+			"CONFIG_ZERV_TOPIC_PATTERN_MATCHES to at least that",
+			(int)match_cnt);
+		k_panic();
+	}
+
+	return 0;
+}
+
+SYS_INIT(zerv_topic_init, PRE_KERNEL_1, 0);
+
+/**
+ * @brief Store an event in the history ring of a topic, overwriting the oldest one when full.
+ * @note Must be called with the history mutex held.
+ */
+static void zerv_topic_history_push(zerv_topic_history_t *history, const void *params)
+{
+	memcpy(&history->samples[history->head * history->sample_size], params,
+	       history->sample_size);
+	history->head = (history->head + 1) % history->depth;
+	if (history->cnt < history->depth) {
+		history->cnt++;
+	}
+}
+
+/**
+ * @brief Pass the events emitted on a topic to the subscribers of that topic or of a pattern
+ * matching it, as one request per subscriber.
+ */
+static void zerv_topic_fan_out(const zerv_topic_t *topic, const zerv_topic_t *subscribed,
+			       size_t params_size, const void *params)
+{
+	for (size_t i = 0; i < subscribed->subscriber_cnt; i++) {
+		const zerv_topic_subscriber_t *subscriber = &subscribed->subscribers[i];
+		zerv_rc_t rc = zerv_internal_client_message_handler(
+			subscriber->serv, subscriber->msg_instance, params_size, params);
+		if (rc != ZERV_RC_OK) {
+			LOG_WRN("Failed to emit topic %s on %s (%i) %s", topic->name,
+				subscriber->serv->name, rc, strerror(-rc));
+		}
+	}
+}
+
+zerv_rc_t zerv_internal_emit_topic(const zerv_topic_t *topic, size_t params_size,
+				   const void *params, size_t cnt)
+{
+	if (topic == NULL || params == NULL) {
+		return ZERV_RC_NULLPTR;
+	}
+
+	if (cnt == 0) {
+		return ZERV_RC_OK;
+	}
+
+	if (topic->is_pattern || params_size != topic->sample_size) {
+		LOG_WRN("Can not emit on %s", topic->name);
+		return ZERV_RC_ERROR;
+	}
+
+	// The history lock is held for the whole fan-out, so that a replay never interleaves with
+	// an emission.
+	zerv_topic_history_t *history = topic->history;
+	if (history != NULL) {
+		k_mutex_lock(history->mtx, K_FOREVER);
+		for (size_t i = 0; i < cnt; i++) {
+			zerv_topic_history_push(history, (const uint8_t *)params + i * params_size);
+		}
+	}
+
+	zerv_topic_fan_out(topic, topic, params_size * cnt, params);
+	for (size_t i = 0; i < topic->match_cnt; i++) {
+		zerv_topic_fan_out(topic, topic->matches[i], params_size * cnt, params);
+	}
+
+	if (history != NULL) {
+		k_mutex_unlock(history->mtx);
+	}
+
+	return ZERV_RC_OK;
+}
+
+zerv_rc_t zerv_internal_replay_topic(const zerv_topic_t *topic,
+				     const zerv_topic_subscriber_t *subscriber, size_t cnt)
+{
+	if (topic == NULL || subscriber == NULL) {
+		return ZERV_RC_NULLPTR;
+	}
+
+	zerv_topic_history_t *history = topic->history;
+	if (history == NULL) {
+		LOG_WRN("Topic %s keeps no history to replay", topic->name);
+		return ZERV_RC_ERROR;
+	}
+
+	const zervice_t *serv = subscriber->serv;
+
+	k_mutex_lock(history->mtx, K_FOREVER);
+
+	cnt = MIN(cnt, history->cnt);
+	if (cnt == 0) {
+		k_mutex_unlock(history->mtx);
+		return ZERV_RC_OK;
+	}
+
+	// The samples are copied oldest first into a single block, which is queued to the zervice
+	// as one request so that the replay is a single operation on the zervice's fifo.
+	zerv_request_t *p_req = k_heap_alloc(
+		serv->heap, cnt * history->sample_size + sizeof(zerv_request_t), K_NO_WAIT);
+	if (p_req == NULL) {
+		LOG_WRN("Failed to allocate replay of topic %s on %s", topic->name, serv->name);
+		k_mutex_unlock(history->mtx);
+		return ZERV_RC_NOMEM;
+	}
+	p_req->id = subscriber->msg_instance->id;
+	p_req->async = NULL;
+	p_req->client_req_params.data_len = cnt * history->sample_size;
+
+	// The oldest samples may wrap around the end of the ring.
+	size_t first = (history->head + history->depth - cnt) % history->depth;
+	size_t tail_cnt = MIN(cnt, history->depth - first);
+	memcpy(p_req->client_req_params.data, &history->samples[first * history->sample_size],
+	       tail_cnt * history->sample_size);
+	memcpy(&p_req->client_req_params.data[tail_cnt * history->sample_size], history->samples,
+	       (cnt - tail_cnt) * history->sample_size);
+	zerv_internal_enqueue(serv, p_req);
+
+	k_mutex_unlock(history->mtx);
+
+	LOG_DBG("Replayed %d events of topic %s on %s", cnt, topic->name, serv->name);
+	return ZERV_RC_OK;
+}
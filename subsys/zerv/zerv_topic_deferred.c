@@ -0,0 +1,140 @@
+/*=================================================================================================
+ *
+ *           ██████╗ ██╗████████╗███╗   ███╗ █████╗ ███╗   ██╗     █████╗ ██████╗
+ *           ██╔══██╗██║╚══██╔══╝████╗ ████║██╔══██╗████╗  ██║    ██╔══██╗██╔══██╗
+ *           ██████╔╝██║   ██║   ██╔████╔██║███████║██╔██╗ ██║    ███████║██████╔╝
+ *           ██╔══██╗██║   ██║   ██║╚██╔╝██║██╔══██║██║╚██╗██║    ██╔══██║██╔══██╗
+ *           ██████╔╝██║   ██║   ██║ ╚═╝ ██║██║  ██║██║ ╚████║    ██║  ██║██████╔╝
+ *           ╚═════╝ ╚═╝   ╚═╝   ╚═╝     ╚═╝╚═╝  ╚═╝╚═╝  ╚═══╝    ╚═╝  ╚═╝╚═════╝
+ *
+ * Description:
+ *     Deferred topic emission through a shared fan-out worker thread.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * Copyright (c) 2023 BitMan AB
+ * contact: albin@bitman.se
+ *=================================================================================================
+ * INCLUDES
+ *===============================================================================================*/
+#include <zephyr/zerv/zerv_internal.h>
+#include <zephyr/kernel.h>
+#include <zephyr/init.h>
+#include <zephyr/logging/log.h>
+#include <string.h>
+
+/*=================================================================================================
+ * PRIVATE MACROS
+ ================================================================================================*/
+LOG_MODULE_REGISTER(zerv_topic_deferred, CONFIG_ZERV_LOG_LEVEL);
+
+/*=================================================================================================
+ * PRIVATE TYPES
+ ================================================================================================*/
+
+/**
+ * @brief A block of events waiting for the fan-out worker.
+ */
+typedef struct {
+	uint32_t unused; // Managed by the k_fifo.
+	const zerv_topic_t *topic;
+	size_t params_size;
+	size_t cnt;
+	uint8_t params[];
+} zerv_topic_deferred_t;
+
+/*=================================================================================================
+ * PRIVATE FUNCTION DECLARATIONS
+ ================================================================================================*/
+static void zerv_topic_deferred_thread(void *p1, void *p2, void *p3);
+
+/*=================================================================================================
+ * PRIVATE VARIABLES
+ ================================================================================================*/
+static K_HEAP_DEFINE(zerv_topic_deferred_heap, CONFIG_ZERV_TOPIC_DEFERRED_HEAP_SIZE);
+static K_FIFO_DEFINE(zerv_topic_deferred_fifo);
+
+// Static threads are only created after the last init level, so the worker is created by
+// zerv_topic_deferred_init instead, where it is given its CPU before it is started.
+static K_THREAD_STACK_DEFINE(zerv_topic_deferred_stack, CONFIG_ZERV_TOPIC_DEFERRED_STACK_SIZE);
+static struct k_thread zerv_topic_deferred_thread_data;
+
+/*=================================================================================================
+ * PRIVATE FUNCTION DEFINITIONS
+ ================================================================================================*/
+
+static void zerv_topic_deferred_thread(void *p1, void *p2, void *p3)
+{
+	ARG_UNUSED(p1);
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	while (true) {
+		zerv_topic_deferred_t *deferred = k_fifo_get(&zerv_topic_deferred_fifo, K_FOREVER);
+		if (deferred == NULL) {
+			continue;
+		}
+
+		zerv_rc_t rc = zerv_internal_emit_topic(deferred->topic, deferred->params_size,
+							deferred->params, deferred->cnt);
+		if (rc != ZERV_RC_OK) {
+			LOG_WRN("Failed to emit deferred topic %s (%i) %s", deferred->topic->name,
+				rc, strerror(-rc));
+		}
+		k_heap_free(&zerv_topic_deferred_heap, deferred);
+	}
+}
+
+static int zerv_topic_deferred_init(void)
+{
+	k_tid_t tid = k_thread_create(&zerv_topic_deferred_thread_data, zerv_topic_deferred_stack,
+				      K_THREAD_STACK_SIZEOF(zerv_topic_deferred_stack),
+				      zerv_topic_deferred_thread, NULL, NULL, NULL,
+				      CONFIG_ZERV_TOPIC_DEFERRED_PRIORITY, 0, K_FOREVER);
+#if defined(CONFIG_ZERV_TOPIC_DEFERRED_CPU) && CONFIG_ZERV_TOPIC_DEFERRED_CPU >= 0
+	int rc = k_thread_cpu_pin(tid, CONFIG_ZERV_TOPIC_DEFERRED_CPU);
+	if (rc != 0) {
+		LOG_ERR("Failed to pin the topic fan-out worker to CPU %d",
+			CONFIG_ZERV_TOPIC_DEFERRED_CPU);
+	}
+#endif
+	k_thread_start(tid);
+	return 0;
+}
+
+SYS_INIT(zerv_topic_deferred_init, APPLICATION, 0);
+
+/*=================================================================================================
+ * PUBLIC FUNCTION DEFINITIONS
+ ================================================================================================*/
+
+zerv_rc_t zerv_internal_emit_topic_deferred(const zerv_topic_t *topic, size_t params_size,
+					    const void *params, size_t cnt)
+{
+	if (topic == NULL || params == NULL) {
+		return ZERV_RC_NULLPTR;
+	}
+
+	if (cnt == 0) {
+		return ZERV_RC_OK;
+	}
+
+	if (topic->is_pattern || params_size != topic->sample_size) {
+		LOG_WRN("Can not emit on %s", topic->name);
+		return ZERV_RC_ERROR;
+	}
+
+	zerv_topic_deferred_t *deferred = k_heap_alloc(
+		&zerv_topic_deferred_heap, sizeof(zerv_topic_deferred_t) + params_size * cnt,
+		K_NO_WAIT);
+	if (deferred == NULL) {
+		LOG_DBG("Failed to allocate deferred emission of topic %s", topic->name);
+		return ZERV_RC_NOMEM;
+	}
+	deferred->topic = topic;
+	deferred->params_size = params_size;
+	deferred->cnt = cnt;
+	memcpy(deferred->params, params, params_size * cnt);
+	k_fifo_put(&zerv_topic_deferred_fifo, deferred);
+
+	return ZERV_RC_OK;
+}
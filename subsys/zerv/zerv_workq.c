@@ -0,0 +1,68 @@
+/*=================================================================================================
+ *
+ *           ██████╗ ██╗████████╗███╗   ███╗ █████╗ ███╗   ██╗     █████╗ ██████╗
+ *           ██╔══██╗██║╚══██╔══╝████╗ ████║██╔══██╗████╗  ██║    ██╔══██╗██╔══██╗
+ *           ██████╔╝██║   ██║   ██╔████╔██║███████║██╔██╗ ██║    ███████║██████╔╝
+ *           ██╔══██╗██║   ██║   ██║╚██╔╝██║██╔══██║██║╚██╗██║    ██╔══██║██╔══██╗
+ *           ██████╔╝██║   ██║   ██║ ╚═╝ ██║██║  ██║██║ ╚████║    ██║  ██║██████╔╝
+ *           ╚═════╝ ╚═╝   ╚═╝   ╚═╝     ╚═╝╚═╝  ╚═╝╚═╝  ╚═══╝    ╚═╝  ╚═╝╚═════╝
+ *
+ * Description:
+ *     Zervices run on work queues.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * Copyright (c) 2023 BitMan AB
+ * contact: albin@bitman.se
+ *=================================================================================================
+ * INCLUDES
+ *===============================================================================================*/
+#include <zephyr/zerv/zerv.h>
+#include <zephyr/zerv/zerv_internal.h>
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+
+/*=================================================================================================
+ * PRIVATE MACROS
+ ================================================================================================*/
+LOG_MODULE_REGISTER(zerv_workq, CONFIG_ZERV_LOG_LEVEL);
+
+/*=================================================================================================
+ * PUBLIC FUNCTION DEFINITIONS
+ ================================================================================================*/
+
+void zerv_internal_workq_submit(const zervice_t *serv)
+{
+	zerv_work_t *work = serv->executor;
+
+	int rc = k_work_submit_to_queue(work->workq != NULL ? work->workq : &k_sys_work_q,
+					&work->work);
+	if (rc < 0) {
+		LOG_ERR("Failed to submit the work of %s (%d)", serv->name, rc);
+	}
+}
+
+void zerv_internal_workq_handler(struct k_work *work)
+{
+	zerv_work_t *zerv_work = CONTAINER_OF(work, zerv_work_t, work);
+	const zervice_t *serv = zerv_work->serv;
+
+	// Only a bounded batch of requests is handled per run, so that a busy zervice can not keep
+	// the work queue from the other work items.
+	for (int i = 0; i < CONFIG_ZERV_WORKQ_BATCH; i++) {
+		zerv_request_t *req = k_fifo_get(serv->fifo, K_NO_WAIT);
+		if (req == NULL) {
+			return;
+		}
+
+		zerv_rc_t rc = zerv_handle_request(serv, req);
+		if (rc != 0) {
+			LOG_ERR("Failed to handle request on %s", serv->name);
+		}
+	}
+
+	// The requests left are handled by the next run, queued behind the other work items. A
+	// running work item is queued again when submitted.
+	if (!k_fifo_is_empty(serv->fifo)) {
+		zerv_internal_workq_submit(serv);
+	}
+}
@@ -0,0 +1,69 @@
+/*=================================================================================================
+ *
+ *           ██████╗ ██╗████████╗███╗   ███╗ █████╗ ███╗   ██╗     █████╗ ██████╗
+ *           ██╔══██╗██║╚══██╔══╝████╗ ████║██╔══██╗████╗  ██║    ██╔══██╗██╔══██╗
+ *           ██████╔╝██║   ██║   ██╔████╔██║███████║██╔██╗ ██║    ███████║██████╔╝
+ *           ██╔══██╗██║   ██║   ██║╚██╔╝██║██╔══██║██║╚██╗██║    ██╔══██║██╔══██╗
+ *           ██████╔╝██║   ██║   ██║ ╚═╝ ██║██║  ██║██║ ╚████║    ██║  ██║██████╔╝
+ *           ╚═════╝ ╚═╝   ╚═╝   ╚═╝     ╚═╝╚═╝  ╚═╝╚═╝  ╚═══╝    ╚═╝  ╚═╝╚═════╝
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * Copyright (c) 2023 BitMan AB
+ * contact: albin@bitman.se
+ *===============================================================================================*/
+#ifndef _BENCH_H_
+#define _BENCH_H_
+
+#include <zephyr/kernel.h>
+#include <zephyr/auxiliary/utils.h>
+#include <stdint.h>
+
+// The time each measurement runs for.
+#define BENCH_DURATION_MS 1000
+
+// The number of worker threads used by the multi-threaded benchmarks.
+#define BENCH_MAX_THREADS 4
+
+#define BENCH_STACK_SIZE 1024
+
+K_THREAD_STACK_ARRAY_DECLARE(bench_stacks, BENCH_MAX_THREADS, BENCH_STACK_SIZE);
+extern struct k_thread bench_threads[BENCH_MAX_THREADS];
+
+/**
+ * @brief Print the result of a measurement as operations per second.
+ *
+ * @param name The name of the measurement.
+ * @param ops The number of operations performed.
+ * @param elapsed_ms The time the operations took.
+ */
+static inline void bench_report(const char *name, uint64_t ops, int64_t elapsed_ms)
+{
+	uint64_t ops_per_sec = elapsed_ms > 0 ? (ops * 1000) / elapsed_ms : 0;
+	PRINTLN("BENCH %s: %u ops in %u ms -> %u ops/s", name, (uint32_t)ops, (uint32_t)elapsed_ms,
+		(uint32_t)ops_per_sec);
+}
+
+/**
+ * @brief Start n benchmark threads running the same entry function.
+ *
+ * The threads are given the index of the thread as the first argument.
+ */
+static inline void bench_start_threads(size_t n, k_thread_entry_t entry, int prio)
+{
+	for (size_t i = 0; i < n; i++) {
+		k_thread_create(&bench_threads[i], bench_stacks[i], BENCH_STACK_SIZE, entry,
+				(void *)i, NULL, NULL, prio, 0, K_NO_WAIT);
+	}
+}
+
+/**
+ * @brief Wait for n benchmark threads started with bench_start_threads to exit.
+ */
+static inline void bench_join_threads(size_t n)
+{
+	for (size_t i = 0; i < n; i++) {
+		k_thread_join(&bench_threads[i], K_FOREVER);
+	}
+}
+
+#endif // _BENCH_H_
@@ -0,0 +1,20 @@
+#include "bench.h"
+
+#include <zephyr/ztest.h>
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/auxiliary/utils.h>
+
+LOG_MODULE_REGISTER(bench_main, LOG_LEVEL_INF);
+
+K_THREAD_STACK_ARRAY_DEFINE(bench_stacks, BENCH_MAX_THREADS, BENCH_STACK_SIZE);
+struct k_thread bench_threads[BENCH_MAX_THREADS];
+
+ZTEST_SUITE(zerv_bench, NULL, NULL, NULL, NULL, NULL);
+
+void test_main(void)
+{
+	PRINTLN("Starting zerv benchmarks on %d CPUs", arch_num_cpus());
+	ztest_run_test_suite(zerv_bench);
+	LOG_PRINTK("\n\n");
+}
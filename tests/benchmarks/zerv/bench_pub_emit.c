@@ -0,0 +1,101 @@
+#include "bench.h"
+#include "pub.h"
+#include "sub.h"
+
+#include <zephyr/ztest.h>
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/sys/atomic.h>
+
+LOG_MODULE_REGISTER(bench_pub_emit, LOG_LEVEL_INF);
+
+#define BENCH_PUB_SUBSCRIBERS 2
+
+PUB_DEFINE(bench_pub);
+SUB_DEFINE(bench_sub_1, 2048);
+SUB_DEFINE(bench_sub_2, 2048);
+SUB_DEFINE(bench_sub_churn, 256);
+
+static struct sub *const bench_subs[BENCH_PUB_SUBSCRIBERS] = {&bench_sub_1, &bench_sub_2};
+
+static atomic_t emitted;
+static atomic_t dropped;
+static volatile bool emitting;
+
+static void drain(void *p1, void *p2, void *p3)
+{
+	struct sub *sub = p1;
+	uint32_t sample;
+
+	while (true) {
+		sub_wait_and_receive(sub, &sample, sizeof(sample), NULL, K_FOREVER);
+	}
+}
+
+K_THREAD_DEFINE(bench_drain_1, 1024, drain, &bench_sub_1, NULL, NULL, K_PRIO_PREEMPT(5), 0, 0);
+K_THREAD_DEFINE(bench_drain_2, 1024, drain, &bench_sub_2, NULL, NULL, K_PRIO_PREEMPT(5), 0, 0);
+
+static void emitter(void *p1, void *p2, void *p3)
+{
+	uint32_t sample = (uint32_t)(uintptr_t)p1;
+
+	while (emitting) {
+		if (pub_emit(&bench_pub, &sample, sizeof(sample)) == 0) {
+			atomic_inc(&emitted);
+		} else {
+			// The subscribers are full, let the drain threads catch up.
+			atomic_inc(&dropped);
+			k_yield();
+		}
+	}
+}
+
+/**
+ * @brief Measure the emission throughput with n concurrent emitters on one publisher, while the
+ * subscriber set is changed in the background.
+ */
+static void bench_pub_emit(size_t n)
+{
+	atomic_set(&emitted, 0);
+	atomic_set(&dropped, 0);
+	emitting = true;
+
+	int64_t start = k_uptime_get();
+	bench_start_threads(n, emitter, K_PRIO_PREEMPT(10));
+
+	// Changing the subscriber set should never have to wait for the emitters.
+	uint32_t churn_cycles_max = 0;
+	while (k_uptime_get() - start < BENCH_DURATION_MS) {
+		uint32_t t0 = k_cycle_get_32();
+		zassert_equal(pub_add_subscriber(&bench_pub, &bench_sub_churn), 0, NULL);
+		zassert_equal(pub_remove_subscriber(&bench_pub, &bench_sub_churn), 0, NULL);
+		churn_cycles_max = MAX(churn_cycles_max, k_cycle_get_32() - t0);
+		k_msleep(10);
+	}
+
+	emitting = false;
+	bench_join_threads(n);
+	int64_t elapsed = k_uptime_get() - start;
+
+	char name[32];
+	snprintk(name, sizeof(name), "pub_emit %d emitters", (int)n);
+	bench_report(name, atomic_get(&emitted), elapsed);
+	PRINTLN("      dropped %d, slowest add+remove %u us", (int)atomic_get(&dropped),
+		k_cyc_to_us_ceil32(churn_cycles_max));
+	zassert_true(atomic_get(&emitted) > 0, NULL);
+}
+
+ZTEST(zerv_bench, test_pub_emit_multi_emitter)
+{
+	for (size_t i = 0; i < BENCH_PUB_SUBSCRIBERS; i++) {
+		zassert_equal(pub_add_subscriber(&bench_pub, bench_subs[i]), 0, NULL);
+	}
+
+	for (size_t n = 1; n <= BENCH_MAX_THREADS; n *= 2) {
+		bench_pub_emit(n);
+	}
+
+	for (size_t i = 0; i < BENCH_PUB_SUBSCRIBERS; i++) {
+		zassert_equal(pub_remove_subscriber(&bench_pub, bench_subs[i]), 0, NULL);
+	}
+}
@@ -0,0 +1,84 @@
+#include "bench.h"
+#include "pub.h"
+#include "sub.h"
+
+#include <zephyr/ztest.h>
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+
+LOG_MODULE_REGISTER(bench_sub_backlog, LOG_LEVEL_INF);
+
+#define BENCH_BACKLOG 10000
+#define BENCH_BACKLOG_BATCH 64
+
+// The record of each 4 byte notification.
+#define BENCH_BACKLOG_RECORD_SIZE                                                                  \
+	ROUND_UP(sizeof(struct notification) + sizeof(struct notification_payload) +               \
+			 sizeof(uint32_t),                                                         \
+		 SUB_RECORD_ALIGN)
+
+// A k_heap allocation is preceded by a chunk header and rounded up to whole chunk units, both of
+// 8 bytes. The heap itself starts with a header holding its free lists.
+#define BENCH_HEAP_CHUNK_UNIT 8
+#define BENCH_HEAP_CHUNK_SIZE(size) ROUND_UP((size) + BENCH_HEAP_CHUNK_UNIT, BENCH_HEAP_CHUNK_UNIT)
+#define BENCH_HEAP_HEADER_SIZE 256
+
+// Room for the whole backlog, in a ring and in a heap.
+#define BENCH_BACKLOG_RING_SIZE (BENCH_BACKLOG * BENCH_BACKLOG_RECORD_SIZE)
+#define BENCH_BACKLOG_HEAP_SIZE                                                                    \
+	(BENCH_BACKLOG * BENCH_HEAP_CHUNK_SIZE(BENCH_BACKLOG_RECORD_SIZE) + BENCH_HEAP_HEADER_SIZE)
+
+PUB_DEFINE(bench_backlog_pub);
+SUB_DEFINE_RING(bench_backlog_sub, BENCH_BACKLOG_RING_SIZE);
+SUB_DEFINE(bench_backlog_heap_sub, BENCH_BACKLOG_HEAP_SIZE);
+
+static void bench_fill_backlog(void)
+{
+	for (uint32_t i = 0; i < BENCH_BACKLOG; i++) {
+		int rc = pub_emit(&bench_backlog_pub, &i, sizeof(i));
+		zassert_equal(rc, 0, "Failed to emit notification %u", i);
+	}
+}
+
+static void bench_catch_up(struct sub *sub, const char *name)
+{
+	zassert_equal(pub_add_subscriber(&bench_backlog_pub, sub), 0, NULL);
+
+	// One notification at a time.
+	bench_fill_backlog();
+	uint32_t t0 = k_cycle_get_32();
+	for (uint32_t i = 0; i < BENCH_BACKLOG; i++) {
+		zassert_equal(sub_wait(sub, K_NO_WAIT), 0, NULL);
+		uint32_t *data = sub_receive(sub, NULL);
+		zassert_equal(*data, i, NULL);
+		sub_free(sub, data);
+	}
+	uint32_t single_us = k_cyc_to_us_ceil32(k_cycle_get_32() - t0);
+
+	// In batches.
+	bench_fill_backlog();
+	struct sub_view views[BENCH_BACKLOG_BATCH];
+	uint32_t received = 0;
+	t0 = k_cycle_get_32();
+	while (received < BENCH_BACKLOG) {
+		int cnt = sub_receive_many(sub, views, ARRAY_SIZE(views), K_NO_WAIT);
+		zassert_true(cnt > 0, NULL);
+		zassert_equal(*(uint32_t *)views[0].data, received, NULL);
+		sub_free_many(sub, views, cnt);
+		received += cnt;
+	}
+	uint32_t batch_us = k_cyc_to_us_ceil32(k_cycle_get_32() - t0);
+
+	PRINTLN("BENCH %s sub catch-up %d notifications: single %u us, batches of %d %u us", name,
+		BENCH_BACKLOG, single_us, BENCH_BACKLOG_BATCH, batch_us);
+
+	zassert_equal(pub_remove_subscriber(&bench_backlog_pub, sub), 0, NULL);
+}
+
+ZTEST(zerv_bench, test_sub_backlog_catch_up)
+{
+	// A single receive and free lock the subscriber for each notification, a batch locks it
+	// once. The heap subscriber also takes the heap lock to free each notification.
+	bench_catch_up(&bench_backlog_heap_sub, "heap");
+	bench_catch_up(&bench_backlog_sub, "ring");
+}
@@ -0,0 +1,98 @@
+#include "bench.h"
+#include "pub.h"
+#include "sub.h"
+
+#include <zephyr/ztest.h>
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/sys/atomic.h>
+
+LOG_MODULE_REGISTER(bench_sub_notify, LOG_LEVEL_INF);
+
+#define BENCH_NOTIFY_ROUND_TRIPS 10000
+#define BENCH_NOTIFY_DEPTH       64
+
+PUB_DEFINE(bench_notify_pub);
+SUB_DEFINE(bench_notify_mutex_sub, BENCH_NOTIFY_DEPTH * 128);
+SUB_DEFINE_LOCKFREE(bench_notify_lockfree_sub, sizeof(uint32_t), BENCH_NOTIFY_DEPTH);
+
+static atomic_t notified;
+static volatile bool notifying;
+
+/**
+ * @brief Measure emitting to, receiving from and freeing on a subscriber from one thread.
+ */
+static void bench_round_trip(struct sub *sub)
+{
+	zassert_equal(pub_add_subscriber(&bench_notify_pub, sub), 0, NULL);
+
+	int64_t start = k_uptime_get();
+	for (uint32_t i = 0; i < BENCH_NOTIFY_ROUND_TRIPS; i++) {
+		zassert_equal(pub_emit(&bench_notify_pub, &i, sizeof(i)), 0, NULL);
+		zassert_equal(sub_wait(sub, K_NO_WAIT), 0, NULL);
+		sub_free(sub, sub_receive(sub, NULL));
+	}
+	int64_t elapsed = k_uptime_get() - start;
+
+	char name[48];
+	snprintk(name, sizeof(name), "round trip %s", sub->name);
+	bench_report(name, BENCH_NOTIFY_ROUND_TRIPS, elapsed);
+
+	zassert_equal(pub_remove_subscriber(&bench_notify_pub, sub), 0, NULL);
+}
+
+static void notifier(void *p1, void *p2, void *p3)
+{
+	uint32_t sample = (uint32_t)(uintptr_t)p1;
+
+	while (notifying) {
+		if (pub_emit(&bench_notify_pub, &sample, sizeof(sample)) == 0) {
+			atomic_inc(&notified);
+		} else {
+			k_yield();
+		}
+	}
+}
+
+/**
+ * @brief Measure the notification throughput of n concurrent emitters while the test thread
+ * drains the subscriber.
+ */
+static void bench_concurrent(struct sub *sub, size_t n)
+{
+	zassert_equal(pub_add_subscriber(&bench_notify_pub, sub), 0, NULL);
+	atomic_set(&notified, 0);
+	notifying = true;
+
+	int64_t start = k_uptime_get();
+	bench_start_threads(n, notifier, K_PRIO_PREEMPT(10));
+	while (k_uptime_get() - start < BENCH_DURATION_MS) {
+		if (sub_wait(sub, K_MSEC(10)) == 0) {
+			sub_free(sub, sub_receive(sub, NULL));
+		}
+	}
+	notifying = false;
+	bench_join_threads(n);
+	int64_t elapsed = k_uptime_get() - start;
+
+	while (sub_wait(sub, K_NO_WAIT) == 0) {
+		sub_free(sub, sub_receive(sub, NULL));
+	}
+
+	char name[48];
+	snprintk(name, sizeof(name), "%s %d emitters", sub->name, (int)n);
+	bench_report(name, atomic_get(&notified), elapsed);
+
+	zassert_equal(pub_remove_subscriber(&bench_notify_pub, sub), 0, NULL);
+}
+
+ZTEST(zerv_bench, test_sub_notify_mutex_vs_lockfree)
+{
+	bench_round_trip(&bench_notify_mutex_sub);
+	bench_round_trip(&bench_notify_lockfree_sub);
+
+	for (size_t n = 1; n <= BENCH_MAX_THREADS; n *= 2) {
+		bench_concurrent(&bench_notify_mutex_sub, n);
+		bench_concurrent(&bench_notify_lockfree_sub, n);
+	}
+}
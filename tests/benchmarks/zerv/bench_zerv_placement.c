@@ -0,0 +1,158 @@
+#include "bench.h"
+
+#include <zephyr/ztest.h>
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/zerv/zerv.h>
+#include <zephyr/zerv/zerv_cmd.h>
+
+LOG_MODULE_REGISTER(bench_zerv_placement, LOG_LEVEL_INF);
+
+// The client is pinned to CPU 0 and calls a zervice on the same CPU, one on another CPU and one
+// left free to run on any CPU.
+ZERV_CMD_DECL(bench_near_ping, ZERV_IN(uint32_t seq), ZERV_OUT(uint32_t seq));
+ZERV_CMD_DECL(bench_far_ping, ZERV_IN(uint32_t seq), ZERV_OUT(uint32_t seq));
+ZERV_CMD_DECL(bench_float_ping, ZERV_IN(uint32_t seq), ZERV_OUT(uint32_t seq));
+
+ZERV_DECL(bench_near, ZERV_CMDS(bench_near_ping), EMPTY, EMPTY);
+ZERV_DECL(bench_far, ZERV_CMDS(bench_far_ping), EMPTY, EMPTY);
+ZERV_DECL(bench_float, ZERV_CMDS(bench_float_ping), EMPTY, EMPTY);
+
+ZERV_DEF_THREAD_PLACED(bench_near, 128, 1024, K_PRIO_PREEMPT(5), ZERV_PLACE_CPUS(BIT(0)), NULL);
+ZERV_DEF_THREAD_PLACED(bench_far, 128, 1024, K_PRIO_PREEMPT(5), ZERV_PLACE_CPUS(BIT(1)), NULL);
+ZERV_DEF_THREAD(bench_float, 128, 1024, K_PRIO_PREEMPT(5), NULL);
+
+ZERV_CMD_HANDLER_DEF(bench_near_ping, in, out)
+{
+	out->seq = in->seq;
+	return 0;
+}
+
+ZERV_CMD_HANDLER_DEF(bench_far_ping, in, out)
+{
+	out->seq = in->seq;
+	return 0;
+}
+
+ZERV_CMD_HANDLER_DEF(bench_float_ping, in, out)
+{
+	out->seq = in->seq;
+	return 0;
+}
+
+enum bench_target {
+	BENCH_NEAR,
+	BENCH_FAR,
+	BENCH_FLOAT,
+};
+
+static const char *const bench_target_names[] = {"same CPU", "other CPU", "any CPU"};
+
+static volatile bool running;
+static uint32_t calls;
+static uint32_t errors;
+static uint32_t max_cycles;
+
+static zerv_rc_t bench_ping(enum bench_target target, uint32_t seq)
+{
+	switch (target) {
+	case BENCH_NEAR: {
+		ZERV_CALL(bench_near, bench_near_ping, rc, p_ret, seq);
+		return rc;
+	}
+	case BENCH_FAR: {
+		ZERV_CALL(bench_far, bench_far_ping, rc, p_ret, seq);
+		return rc;
+	}
+	default: {
+		ZERV_CALL(bench_float, bench_float_ping, rc, p_ret, seq);
+		return rc;
+	}
+	}
+}
+
+static void client(void *p1, void *p2, void *p3)
+{
+	enum bench_target target = (enum bench_target)(uintptr_t)p1;
+
+	while (running) {
+		uint32_t start = k_cycle_get_32();
+		zerv_rc_t rc = bench_ping(target, calls);
+		uint32_t cycles = k_cycle_get_32() - start;
+		if (rc != ZERV_RC_OK) {
+			errors++;
+		}
+		max_cycles = MAX(max_cycles, cycles);
+		calls++;
+	}
+}
+
+// Keeps the CPUs other than the one of the client busy.
+static void load(void *p1, void *p2, void *p3)
+{
+	while (running) {
+		k_busy_wait(50);
+		k_yield();
+	}
+}
+
+/**
+ * @brief Create a benchmark thread that is only started once it has been placed on its CPUs.
+ */
+static void bench_start_placed(size_t i, k_thread_entry_t entry, void *arg, uint32_t cpu_mask)
+{
+	k_tid_t tid = k_thread_create(&bench_threads[i], bench_stacks[i], BENCH_STACK_SIZE, entry,
+				      arg, NULL, NULL, K_PRIO_PREEMPT(10), 0, K_FOREVER);
+	k_thread_cpu_mask_clear(tid);
+	for (unsigned int cpu = 0; cpu < arch_num_cpus(); cpu++) {
+		if (cpu_mask & BIT(cpu)) {
+			k_thread_cpu_mask_enable(tid, cpu);
+		}
+	}
+	k_thread_start(tid);
+}
+
+/**
+ * @brief Measure the round trip time of a command from a client on CPU 0 to a zervice.
+ */
+static void bench_round_trip(enum bench_target target, bool loaded)
+{
+	uint32_t others = BIT_MASK(arch_num_cpus()) & ~BIT(0);
+	size_t load_cnt = loaded && others != 0 ? BENCH_MAX_THREADS - 1 : 0;
+
+	calls = 0;
+	errors = 0;
+	max_cycles = 0;
+	running = true;
+
+	int64_t start = k_uptime_get();
+	bench_start_placed(0, client, (void *)(uintptr_t)target, BIT(0));
+	for (size_t i = 1; i <= load_cnt; i++) {
+		bench_start_placed(i, load, NULL, others);
+	}
+	k_msleep(BENCH_DURATION_MS);
+	running = false;
+	bench_join_threads(load_cnt + 1);
+	int64_t elapsed = k_uptime_get() - start;
+
+	char name[48];
+	snprintk(name, sizeof(name), "zervice on %s%s", bench_target_names[target],
+		 loaded ? " loaded" : "");
+	bench_report(name, calls, elapsed);
+	PRINTLN("      avg %u ns max %u ns",
+		(uint32_t)(calls > 0 ? elapsed * 1000000 / calls : 0),
+		(uint32_t)k_cyc_to_ns_near64(max_cycles));
+	zassert_equal(errors, 0, "Failed calls to the zervice");
+}
+
+ZTEST(zerv_bench, test_zerv_placement)
+{
+	if (arch_num_cpus() < 2) {
+		ztest_test_skip();
+	}
+
+	for (int target = BENCH_NEAR; target <= BENCH_FLOAT; target++) {
+		bench_round_trip(target, false);
+		bench_round_trip(target, true);
+	}
+}
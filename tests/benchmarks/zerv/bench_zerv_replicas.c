@@ -0,0 +1,138 @@
+/*=================================================================================================
+ *
+ *           ██████╗ ██╗████████╗███╗   ███╗ █████╗ ███╗   ██╗     █████╗ ██████╗
+ *           ██╔══██╗██║╚══██╔══╝████╗ ████║██╔══██╗████╗  ██║    ██╔══██╗██╔══██╗
+ *           ██████╔╝██║   ██║   ██╔████╔██║███████║██╔██╗ ██║    ███████║██████╔╝
+ *           ██╔══██╗██║   ██║   ██║╚██╔╝██║██╔══██║██║╚██╗██║    ██╔══██║██╔══██╗
+ *           ██████╔╝██║   ██║   ██║ ╚═╝ ██║██║  ██║██║ ╚████║    ██║  ██║██████╔╝
+ *           ╚═════╝ ╚═╝   ╚═╝   ╚═╝     ╚═╝╚═╝  ╚═╝╚═╝  ╚═══╝    ╚═╝  ╚═╝╚═════╝
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * Copyright (c) 2023 BitMan AB
+ * contact: albin@bitman.se
+ *===============================================================================================*/
+#include "bench.h"
+
+#include <zephyr/ztest.h>
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/zerv/zerv.h>
+#include <zephyr/zerv/zerv_cmd.h>
+
+LOG_MODULE_REGISTER(bench_zerv_replicas, LOG_LEVEL_INF);
+
+// The same CPU bound parallel command served by one, two and four worker threads.
+ZERV_CMD_DECL_PARALLEL(bench_repl_1_hash, ZERV_IN(uint32_t seed), ZERV_OUT(uint32_t hash));
+ZERV_CMD_DECL_PARALLEL(bench_repl_2_hash, ZERV_IN(uint32_t seed), ZERV_OUT(uint32_t hash));
+ZERV_CMD_DECL_PARALLEL(bench_repl_4_hash, ZERV_IN(uint32_t seed), ZERV_OUT(uint32_t hash));
+
+ZERV_DECL(bench_repl_1, ZERV_CMDS(bench_repl_1_hash), EMPTY, EMPTY);
+ZERV_DECL(bench_repl_2, ZERV_CMDS(bench_repl_2_hash), EMPTY, EMPTY);
+ZERV_DECL(bench_repl_4, ZERV_CMDS(bench_repl_4_hash), EMPTY, EMPTY);
+
+ZERV_DEF_REPLICATED(bench_repl_1, 128, 1024, K_PRIO_PREEMPT(5), 1, NULL);
+ZERV_DEF_REPLICATED(bench_repl_2, 128, 1024, K_PRIO_PREEMPT(5), 2, NULL);
+ZERV_DEF_REPLICATED(bench_repl_4, 128, 1024, K_PRIO_PREEMPT(5), 4, NULL);
+
+static uint8_t bench_data[256];
+
+/**
+ * @brief FNV-1a hash of the benchmark data, repeated to give each command some work.
+ */
+static uint32_t bench_hash(uint32_t seed)
+{
+	uint32_t hash = 2166136261u ^ seed;
+	for (int round = 0; round < 8; round++) {
+		for (size_t i = 0; i < sizeof(bench_data); i++) {
+			hash = (hash ^ bench_data[i]) * 16777619u;
+		}
+	}
+	return hash;
+}
+
+ZERV_CMD_HANDLER_DEF(bench_repl_1_hash, in, out)
+{
+	out->hash = bench_hash(in->seed);
+	return 0;
+}
+
+ZERV_CMD_HANDLER_DEF(bench_repl_2_hash, in, out)
+{
+	out->hash = bench_hash(in->seed);
+	return 0;
+}
+
+ZERV_CMD_HANDLER_DEF(bench_repl_4_hash, in, out)
+{
+	out->hash = bench_hash(in->seed);
+	return 0;
+}
+
+static volatile bool running;
+static size_t workers;
+static atomic_t calls;
+static atomic_t errors;
+
+static zerv_rc_t bench_call(uint32_t seed)
+{
+	switch (workers) {
+	case 1: {
+		ZERV_CALL(bench_repl_1, bench_repl_1_hash, rc, p_ret, seed);
+		return rc;
+	}
+	case 2: {
+		ZERV_CALL(bench_repl_2, bench_repl_2_hash, rc, p_ret, seed);
+		return rc;
+	}
+	default: {
+		ZERV_CALL(bench_repl_4, bench_repl_4_hash, rc, p_ret, seed);
+		return rc;
+	}
+	}
+}
+
+static void client(void *p1, void *p2, void *p3)
+{
+	uint32_t seed = (uint32_t)(uintptr_t)p1;
+
+	while (running) {
+		if (bench_call(seed++) != ZERV_RC_OK) {
+			atomic_inc(&errors);
+		}
+		atomic_inc(&calls);
+	}
+}
+
+/**
+ * @brief Measure the command throughput of a zervice with the given number of workers.
+ */
+static void bench_replicas(size_t worker_cnt)
+{
+	workers = worker_cnt;
+	atomic_set(&calls, 0);
+	atomic_set(&errors, 0);
+	running = true;
+
+	int64_t start = k_uptime_get();
+	bench_start_threads(BENCH_MAX_THREADS, client, K_PRIO_PREEMPT(10));
+	k_msleep(BENCH_DURATION_MS);
+	running = false;
+	bench_join_threads(BENCH_MAX_THREADS);
+	int64_t elapsed = k_uptime_get() - start;
+
+	char name[48];
+	snprintk(name, sizeof(name), "zervice with %u workers", (unsigned int)worker_cnt);
+	bench_report(name, atomic_get(&calls), elapsed);
+	zassert_equal(atomic_get(&errors), 0, "Failed calls to the zervice");
+}
+
+ZTEST(zerv_bench, test_zerv_replicas)
+{
+	for (size_t i = 0; i < sizeof(bench_data); i++) {
+		bench_data[i] = (uint8_t)i;
+	}
+
+	bench_replicas(1);
+	bench_replicas(2);
+	bench_replicas(4);
+}
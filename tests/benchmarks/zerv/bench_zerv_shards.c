@@ -0,0 +1,142 @@
+/*=================================================================================================
+ *
+ *           ██████╗ ██╗████████╗███╗   ███╗ █████╗ ███╗   ██╗     █████╗ ██████╗
+ *           ██╔══██╗██║╚══██╔══╝████╗ ████║██╔══██╗████╗  ██║    ██╔══██╗██╔══██╗
+ *           ██████╔╝██║   ██║   ██╔████╔██║███████║██╔██╗ ██║    ███████║██████╔╝
+ *           ██╔══██╗██║   ██║   ██║╚██╔╝██║██╔══██║██║╚██╗██║    ██╔══██║██╔══██╗
+ *           ██████╔╝██║   ██║   ██║ ╚═╝ ██║██║  ██║██║ ╚████║    ██║  ██║██████╔╝
+ *           ╚═════╝ ╚═╝   ╚═╝   ╚═╝     ╚═╝╚═╝  ╚═╝╚═╝  ╚═══╝    ╚═╝  ╚═╝╚═════╝
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * Copyright (c) 2023 BitMan AB
+ * contact: albin@bitman.se
+ *===============================================================================================*/
+#include "bench.h"
+
+#include <zephyr/ztest.h>
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/zerv/zerv.h>
+#include <zephyr/zerv/zerv_cmd.h>
+
+LOG_MODULE_REGISTER(bench_zerv_shards, LOG_LEVEL_INF);
+
+#define BENCH_TABLE_SIZE 64
+
+// A table of counters partitioned over one, two and four shards. Each client updates the keys of
+// its own, which are spread over the shards.
+ZERV_CMD_DECL(bench_shard_1_add, ZERV_IN(uint32_t key), ZERV_OUT(uint32_t cnt));
+ZERV_CMD_DECL(bench_shard_2_add, ZERV_IN(uint32_t key), ZERV_OUT(uint32_t cnt));
+ZERV_CMD_DECL(bench_shard_4_add, ZERV_IN(uint32_t key), ZERV_OUT(uint32_t cnt));
+
+ZERV_DECL(bench_shard_1, ZERV_CMDS(bench_shard_1_add), EMPTY, EMPTY);
+ZERV_DECL(bench_shard_2, ZERV_CMDS(bench_shard_2_add), EMPTY, EMPTY);
+ZERV_DECL(bench_shard_4, ZERV_CMDS(bench_shard_4_add), EMPTY, EMPTY);
+
+static uint32_t bench_key(const void *params, size_t params_len)
+{
+	return *(const uint32_t *)params;
+}
+
+ZERV_DEF_SHARDED(bench_shard_1, 128, 1024, K_PRIO_PREEMPT(5), 1, bench_key, NULL);
+ZERV_DEF_SHARDED(bench_shard_2, 128, 1024, K_PRIO_PREEMPT(5), 2, bench_key, NULL);
+ZERV_DEF_SHARDED(bench_shard_4, 128, 1024, K_PRIO_PREEMPT(5), 4, bench_key, NULL);
+
+static uint32_t bench_table[BENCH_TABLE_SIZE];
+
+ZERV_CMD_HANDLER_DEF(bench_shard_1_add, in, out)
+{
+	out->cnt = ++bench_table[in->key % BENCH_TABLE_SIZE];
+	return 0;
+}
+
+ZERV_CMD_HANDLER_DEF(bench_shard_2_add, in, out)
+{
+	out->cnt = ++bench_table[in->key % BENCH_TABLE_SIZE];
+	return 0;
+}
+
+ZERV_CMD_HANDLER_DEF(bench_shard_4_add, in, out)
+{
+	out->cnt = ++bench_table[in->key % BENCH_TABLE_SIZE];
+	return 0;
+}
+
+static volatile bool running;
+static size_t shards;
+static atomic_t calls;
+static atomic_t locked;
+static atomic_t errors;
+
+static zerv_rc_t bench_add(uint32_t key)
+{
+	switch (shards) {
+	case 1: {
+		ZERV_CALL(bench_shard_1, bench_shard_1_add, rc, p_ret, key);
+		return rc;
+	}
+	case 2: {
+		ZERV_CALL(bench_shard_2, bench_shard_2_add, rc, p_ret, key);
+		return rc;
+	}
+	default: {
+		ZERV_CALL(bench_shard_4, bench_shard_4_add, rc, p_ret, key);
+		return rc;
+	}
+	}
+}
+
+static void client(void *p1, void *p2, void *p3)
+{
+	// Client i owns the keys i, i + BENCH_MAX_THREADS, ..., which land on shard i modulo the
+	// number of shards.
+	uint32_t key = (uint32_t)(uintptr_t)p1;
+
+	while (running) {
+		zerv_rc_t rc = bench_add(key);
+		if (rc == ZERV_RC_LOCKED) {
+			// Another client is calling the same shard.
+			atomic_inc(&locked);
+			k_yield();
+			continue;
+		}
+		if (rc != ZERV_RC_OK) {
+			atomic_inc(&errors);
+		}
+		atomic_inc(&calls);
+		key = (key + BENCH_MAX_THREADS) % BENCH_TABLE_SIZE;
+	}
+}
+
+/**
+ * @brief Measure the throughput of BENCH_MAX_THREADS clients calling a zervice with the given
+ * number of shards.
+ */
+static void bench_shards(size_t shard_cnt)
+{
+	shards = shard_cnt;
+	atomic_set(&calls, 0);
+	atomic_set(&locked, 0);
+	atomic_set(&errors, 0);
+	running = true;
+
+	int64_t start = k_uptime_get();
+	bench_start_threads(BENCH_MAX_THREADS, client, K_PRIO_PREEMPT(10));
+	k_msleep(BENCH_DURATION_MS);
+	running = false;
+	bench_join_threads(BENCH_MAX_THREADS);
+	int64_t elapsed = k_uptime_get() - start;
+
+	char name[48];
+	snprintk(name, sizeof(name), "zervice with %u shards", (unsigned int)shard_cnt);
+	bench_report(name, atomic_get(&calls), elapsed);
+	PRINTLN("      %u calls found their shard busy", (uint32_t)atomic_get(&locked));
+	zassert_equal(atomic_get(&errors), 0, "Failed calls to the zervice");
+}
+
+ZTEST(zerv_bench, test_zerv_shards)
+{
+	bench_shards(1);
+	bench_shards(2);
+	bench_shards(4);
+}
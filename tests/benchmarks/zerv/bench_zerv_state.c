@@ -0,0 +1,94 @@
+#include "bench.h"
+
+#include <zephyr/ztest.h>
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/sys/atomic.h>
+#include <zephyr/zerv/zerv.h>
+#include <zephyr/zerv/zerv_state.h>
+
+LOG_MODULE_REGISTER(bench_zerv_state, LOG_LEVEL_INF);
+
+// Every field is written with the same value, so a torn read shows up as differing fields.
+struct bench_state {
+	uint32_t a;
+	uint32_t b;
+	uint32_t c;
+	uint32_t d;
+};
+
+ZERV_DECL(bench_state_owner, EMPTY, EMPTY, EMPTY);
+ZERV_DEF(bench_state_owner, 64);
+
+ZERV_STATE_DECL(bench_state, struct bench_state);
+ZERV_STATE_DEF(bench_state_owner, bench_state, struct bench_state);
+
+static atomic_t reads;
+static atomic_t writes;
+static atomic_t torn;
+static size_t writer_cnt;
+static volatile bool running;
+
+static void state_worker(void *p1, void *p2, void *p3)
+{
+	size_t index = (size_t)p1;
+
+	if (index < writer_cnt) {
+		uint32_t value = 0;
+		while (running) {
+			value++;
+			struct bench_state state = {.a = value, .b = value, .c = value, .d = value};
+			ZERV_STATE_PUBLISH(bench_state, &state);
+			atomic_inc(&writes);
+			k_yield();
+		}
+		return;
+	}
+
+	uint32_t cnt = 0;
+	while (running) {
+		struct bench_state state;
+		ZERV_STATE_READ(bench_state, &state);
+		if (state.a != state.b || state.a != state.c || state.a != state.d) {
+			atomic_inc(&torn);
+		}
+		if (++cnt % 256 == 0) {
+			atomic_add(&reads, 256);
+			k_yield();
+		}
+	}
+}
+
+/**
+ * @brief Measure the read throughput of the reader threads while writer threads update the
+ * state.
+ */
+static void bench_state_read(size_t writers)
+{
+	atomic_set(&reads, 0);
+	atomic_set(&writes, 0);
+	atomic_set(&torn, 0);
+	writer_cnt = writers;
+	running = true;
+
+	int64_t start = k_uptime_get();
+	bench_start_threads(BENCH_MAX_THREADS, state_worker, K_PRIO_PREEMPT(10));
+	k_msleep(BENCH_DURATION_MS);
+	running = false;
+	bench_join_threads(BENCH_MAX_THREADS);
+	int64_t elapsed = k_uptime_get() - start;
+
+	char name[48];
+	snprintk(name, sizeof(name), "state read %d readers %d writers",
+		 (int)(BENCH_MAX_THREADS - writers), (int)writers);
+	bench_report(name, atomic_get(&reads), elapsed);
+	PRINTLN("      writes %d", (int)atomic_get(&writes));
+	zassert_equal(atomic_get(&torn), 0, "Read a torn state");
+}
+
+ZTEST(zerv_bench, test_zerv_state_read)
+{
+	for (size_t writers = 0; writers < BENCH_MAX_THREADS; writers++) {
+		bench_state_read(writers);
+	}
+}
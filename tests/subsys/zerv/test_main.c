@@ -5,6 +5,15 @@
 #include "zerv_test_service_poll.h"
 #include "zerv_msg_test_service.h"
 #include "zerv_test_periodic_thread.h"
+#include "zerv_test_pooled.h"
+#include "zerv_test_workq.h"
+#include "zerv_test_async.h"
+#include "zerv_test_replicated.h"
+#include "zerv_test_sharded.h"
+#include "zerv_test_prio.h"
+#include "zerv_test_lazy.h"
+#include "zerv_test_init.h"
+#include "zerv_test_const.h"
 
 #include <zephyr/zerv/zerv.h>
 #include <zephyr/zerv/zerv_msg.h>
@@ -35,8 +44,53 @@ SUB_DEFINE(dummy_subscriber, 0);
 // Define a publisher with no subscribers
 PUB_DEFINE(lone_publisher);
 
+// Publisher whose subscriber is added and removed by the test
+PUB_DEFINE(removed_pub);
+SUB_DEFINE(removed_sub, 64);
+
+// Publisher sharing its notifications between the subscribers
+PUB_DEFINE_SHARED(shared_pub, 256);
+SUB_DEFINE(shared_sub_1, 64);
+SUB_DEFINE(shared_sub_2, 64);
+
+// Subscriber queueing its notifications in a byte ring
+PUB_DEFINE(ring_pub);
+SUB_DEFINE_RING(ring_sub, 512);
+
+// Subscribers waited on together by one thread
+PUB_DEFINE(any_pub_1);
+PUB_DEFINE(any_pub_2);
+SUB_DEFINE(any_sub_1, 256);
+SUB_DEFINE_RING(any_sub_2, 256);
+
+// Publisher with a subscriber too slow to keep up ahead of a fast one
+PUB_DEFINE(lossy_pub);
+SUB_DEFINE(lossy_slow_sub, 64);
+SUB_DEFINE(lossy_fast_sub, 1024);
+
+// Typed publisher and subscribers of fixed-size records
+struct typed_sample {
+	int16_t x;
+	int16_t y;
+	int16_t z;
+};
+PUB_DEFINE_TYPED(typed_pub, struct typed_sample);
+SUB_DEFINE_TYPED(typed_sub, struct typed_sample, 4);
+SUB_DEFINE_TYPED(typed_byte_sub, uint8_t, 4);
+
+// Subscriber queueing its notifications without locks
+PUB_DEFINE(lockfree_pub);
+SUB_DEFINE_LOCKFREE(lockfree_sub, 16, 4);
+
+// Subscriber draining its notifications in batches
+PUB_DEFINE(batch_pub);
+SUB_DEFINE(batch_sub, 512);
+
 ZTEST_SUITE(zerv, NULL, NULL, NULL, NULL, NULL);
 
+// The result of waiting for the zervices to be initialized before the tests.
+static zerv_rc_t boot_ready_rc = ZERV_RC_ERROR;
+
 void test_main(void)
 {
 	PRINTLN("Starting test_main");
@@ -53,7 +107,28 @@ void test_main(void)
 
 	pub_add_subscriber(&pub3, &sub5);
 
-	k_sleep(K_MSEC(100));
+	pub_add_subscriber(&shared_pub, &shared_sub_1);
+	pub_add_subscriber(&shared_pub, &shared_sub_2);
+
+	pub_add_subscriber(&ring_pub, &ring_sub);
+
+	pub_add_subscriber(&any_pub_1, &any_sub_1);
+	pub_add_subscriber(&any_pub_2, &any_sub_2);
+
+	pub_add_subscriber(&lossy_pub, &lossy_slow_sub);
+	pub_add_subscriber(&lossy_pub, &lossy_fast_sub);
+
+	PUB_ADD_SUBSCRIBER_TYPED(typed_pub, typed_sub);
+
+	pub_add_subscriber(&lockfree_pub, &lockfree_sub);
+
+	pub_add_subscriber(&batch_pub, &batch_sub);
+
+	boot_ready_rc = zerv_wait_ready(K_SECONDS(1));
+	if (boot_ready_rc != ZERV_RC_OK) {
+		LOG_ERR("The zervices failed to initialize: %s", zerv_rc_to_str(boot_ready_rc));
+	}
+	zerv_boot_report();
 
 	ztest_run_test_suite(zerv);
 	LOG_PRINTK("\n\n");
@@ -62,64 +137,41 @@ void test_main(void)
 static bool polling_test_2 = false;
 
 char sub_1_msg[50];
-void sub1_thread(void)
-{
-	PRINTLN("sub1_thread started");
-	while (1) {
-		const struct pub *p_pub =
-			sub_wait_and_receive(&sub1, sub_1_msg, sizeof(sub_1_msg), NULL, K_FOREVER);
-		if (polling_test_2) {
-			return;
-		}
-		PRINTLN("from publisher %s sub1 received: %s", p_pub->name, sub_1_msg);
-	}
-}
-K_THREAD_DEFINE(sub1_thread_id, 256, (k_thread_entry_t)sub1_thread, NULL, NULL, NULL, 5, 0, 0);
-
 char sub_2_msg[50];
-void sub2_thread(void)
-{
-	PRINTLN("sub2_thread started");
-	while (1) {
-		const struct pub *p_pub =
-			sub_wait_and_receive(&sub2, sub_2_msg, sizeof(sub_2_msg), NULL, K_FOREVER);
-		if (polling_test_2) {
-			return;
-		}
-		PRINTLN("from publisher %s received: %s", p_pub->name, sub_2_msg);
-	}
-}
-K_THREAD_DEFINE(sub2_thread_id, 256, (k_thread_entry_t)sub2_thread, NULL, NULL, NULL, 5, 0, 0);
-
 char sub_3_msg[50];
-void sub3_thread(void)
-{
-	PRINTLN("sub3_thread started");
-	while (1) {
-		const struct pub *p_pub =
-			sub_wait_and_receive(&sub3, sub_3_msg, sizeof(sub_3_msg), NULL, K_FOREVER);
-		if (polling_test_2) {
-			return;
-		}
-		PRINTLN("from publisher %s sub3 received: %s", p_pub->name, sub_3_msg);
-	}
-}
-K_THREAD_DEFINE(sub3_thread_id, 256, (k_thread_entry_t)sub3_thread, NULL, NULL, NULL, 5, 0, 0);
-
 char sub_4_msg[50];
-void sub4_thread(void)
+
+static struct sub *const consumer_subs[] = {&sub1, &sub2, &sub3, &sub4};
+static char (*const consumer_msgs[])[sizeof(sub_1_msg)] = {&sub_1_msg, &sub_2_msg, &sub_3_msg,
+							     &sub_4_msg};
+
+void sub_consumer_thread(void)
 {
-	PRINTLN("sub4_thread started");
+	PRINTLN("sub_consumer_thread started");
 	while (1) {
-		const struct pub *p_pub =
-			sub_wait_and_receive(&sub4, sub_4_msg, sizeof(sub_4_msg), NULL, K_FOREVER);
+		struct sub_view view;
+		struct sub *sub = sub_wait_any(consumer_subs, ARRAY_SIZE(consumer_subs), &view,
+					       K_FOREVER);
+		if (sub == NULL) {
+			continue;
+		}
 		if (polling_test_2) {
+			sub_free(sub, view.data);
 			return;
 		}
-		PRINTLN("from publisher %s sub4 received: %s", p_pub->name, sub_4_msg);
+		for (size_t i = 0; i < ARRAY_SIZE(consumer_subs); i++) {
+			if (consumer_subs[i] == sub) {
+				memcpy(*consumer_msgs[i], view.data,
+				       MIN(view.size, sizeof(*consumer_msgs[i])));
+				PRINTLN("from publisher %s %s received: %s", view.emittor->name,
+					sub->name, *consumer_msgs[i]);
+			}
+		}
+		sub_free(sub, view.data);
 	}
 }
-K_THREAD_DEFINE(sub4_thread_id, 256, (k_thread_entry_t)sub4_thread, NULL, NULL, NULL, 5, 0, 0);
+K_THREAD_DEFINE(sub_consumer_thread_id, 512, (k_thread_entry_t)sub_consumer_thread, NULL, NULL,
+		NULL, 5, 0, 0);
 
 char sub_5_msg[50];
 static bool dont_free_message = false;
@@ -558,5 +610,672 @@ ZTEST(zerv, test_topic)
 		PRINTLN("OK");
 	}
 
-	k_sleep(K_MSEC(100));
+	// All three subscribers of the topic should receive the event.
+	for (int i = 0; i < 3; i++) {
+		int ret = k_sem_take(&test_topic_sem, K_MSEC(100));
+		zassert_equal(ret, 0, NULL);
+	}
+}
+
+ZTEST(zerv, test_topic_history)
+{
+	for (int seq = 1; seq <= 6; seq++) {
+		zerv_rc_t rc = ZERV_TOPIC_EMIT(history_topic, seq);
+		zassert_equal(rc, ZERV_RC_OK, NULL);
+		int ret = k_sem_take(&history_topic_sem, K_MSEC(100));
+		zassert_equal(ret, 0, NULL);
+	}
+
+	// Only the last four events are kept, so the last three should be replayed oldest first.
+	PRINTLN("Replaying history_topic");
+	zerv_rc_t rc = ZERV_TOPIC_REPLAY(zerv_test_service, history_topic, 3);
+	zassert_equal(rc, ZERV_RC_OK, NULL);
+	for (int i = 0; i < 3; i++) {
+		int ret = k_sem_take(&history_topic_sem, K_MSEC(100));
+		zassert_equal(ret, 0, NULL);
+	}
+
+	// The replayed events follow the live ones in the order they were emitted.
+	const int expected[] = {1, 2, 3, 4, 5, 6, 4, 5, 6};
+	zassert_equal(history_topic_recv_cnt, ARRAY_SIZE(expected), NULL);
+	zassert_mem_equal(history_topic_seqs, expected, sizeof(expected), NULL);
+	PRINTLN("OK");
+}
+
+ZTEST(zerv, test_topic_pattern)
+{
+	// Both accelerometer topics match the pattern.
+	zerv_rc_t rc = ZERV_TOPIC_EMIT(imu0_accel, 0, 100);
+	zassert_equal(rc, ZERV_RC_OK, NULL);
+	int ret = k_sem_take(&any_imu_accel_sem, K_MSEC(100));
+	zassert_equal(ret, 0, NULL);
+	zassert_equal(any_imu_accel_last_imu, 0, NULL);
+
+	rc = ZERV_TOPIC_EMIT(imu1_accel, 1, 200);
+	zassert_equal(rc, ZERV_RC_OK, NULL);
+	ret = k_sem_take(&any_imu_accel_sem, K_MSEC(100));
+	zassert_equal(ret, 0, NULL);
+	zassert_equal(any_imu_accel_last_imu, 1, NULL);
+
+	// The gyroscope topic does not.
+	rc = ZERV_TOPIC_EMIT(imu0_gyro, 0, 300);
+	zassert_equal(rc, ZERV_RC_OK, NULL);
+	ret = k_sem_take(&any_imu_accel_sem, K_MSEC(100));
+	zassert_equal(ret, -EAGAIN, NULL);
+
+	// Events can not be emitted on a pattern.
+	rc = ZERV_TOPIC_EMIT(any_imu_accel, 0, 0);
+	zassert_equal(rc, ZERV_RC_ERROR, NULL);
+	PRINTLN("OK");
+}
+
+ZTEST(zerv, test_topic_batch)
+{
+	batch_topic_zerv_topic_t samples[8];
+	for (int i = 0; i < ARRAY_SIZE(samples); i++) {
+		samples[i].sample = i + 1;
+	}
+
+	zerv_rc_t rc = ZERV_TOPIC_EMIT_BATCH(batch_topic, samples, ARRAY_SIZE(samples));
+	zassert_equal(rc, ZERV_RC_OK, NULL);
+
+	// The batch handler gets the whole block in one call.
+	int ret = k_sem_take(&batch_topic_block_sem, K_MSEC(100));
+	zassert_equal(ret, 0, NULL);
+	zassert_equal(batch_topic_block_cnt, ARRAY_SIZE(samples), NULL);
+	zassert_equal(batch_topic_block_sum, 36, NULL);
+
+	// The plain handler gets the samples one by one.
+	for (int i = 0; i < ARRAY_SIZE(samples); i++) {
+		ret = k_sem_take(&batch_topic_sem, K_MSEC(100));
+		zassert_equal(ret, 0, NULL);
+	}
+	zassert_equal(batch_topic_sample_sum, 36, NULL);
+	PRINTLN("OK");
+}
+
+ZTEST(zerv, test_topic_deferred)
+{
+	int sample_sum = batch_topic_sample_sum;
+
+	zerv_rc_t rc = ZERV_TOPIC_EMIT_DEFERRED(batch_topic, 5);
+	zassert_equal(rc, ZERV_RC_OK, NULL);
+
+	// The fan-out worker passes the event on to both subscribers.
+	int ret = k_sem_take(&batch_topic_block_sem, K_MSEC(100));
+	zassert_equal(ret, 0, NULL);
+	zassert_equal(batch_topic_block_cnt, 1, NULL);
+	zassert_equal(batch_topic_block_sum, 5, NULL);
+	ret = k_sem_take(&batch_topic_sem, K_MSEC(100));
+	zassert_equal(ret, 0, NULL);
+	zassert_equal(batch_topic_sample_sum, sample_sum + 5, NULL);
+	PRINTLN("OK");
+}
+
+ZTEST(zerv, test_pub_remove_subscriber)
+{
+	uint8_t data = 0x5a;
+	struct pub_emit_result result;
+
+	zassert_equal(pub_add_subscriber(&removed_pub, &removed_sub), 0, NULL);
+	zassert_equal(pub_emit_with_result(&removed_pub, &data, sizeof(data), &result), 0, NULL);
+	zassert_equal(result.delivered, 1, NULL);
+	zassert_equal(sub_wait(&removed_sub, K_NO_WAIT), 0, NULL);
+	sub_free(&removed_sub, sub_receive(&removed_sub, NULL));
+
+	zassert_equal(pub_remove_subscriber(&removed_pub, &removed_sub), 0, NULL);
+
+	// A subscriber that is not subscribed can not be removed again.
+	zassert_equal(pub_remove_subscriber(&removed_pub, &removed_sub), -ENOENT, NULL);
+
+	// The publisher no longer notifies the removed subscriber.
+	zassert_equal(pub_emit_with_result(&removed_pub, &data, sizeof(data), &result), 0, NULL);
+	zassert_equal(result.delivered, 0, NULL);
+	zassert_equal(sub_wait(&removed_sub, K_NO_WAIT), -EAGAIN, NULL);
+	PRINTLN("OK");
+}
+
+ZTEST(zerv, test_pub_sub_shared)
+{
+	// The frame is larger than the heaps of the subscribers, so it can only be delivered by
+	// reference. Emitting more frames than the publisher heap can hold at once checks that the
+	// frames are freed once both subscribers are done with them.
+	uint8_t frame[96];
+	for (int i = 0; i < 10; i++) {
+		memset(frame, i, sizeof(frame));
+		int rc = pub_emit(&shared_pub, frame, sizeof(frame));
+		zassert_equal(rc, 0, NULL);
+
+		zassert_equal(sub_wait(&shared_sub_1, K_NO_WAIT), 0, NULL);
+		zassert_equal(sub_wait(&shared_sub_2, K_NO_WAIT), 0, NULL);
+		size_t size_1;
+		size_t size_2;
+		uint8_t *data_1 = sub_receive(&shared_sub_1, &size_1);
+		uint8_t *data_2 = sub_receive(&shared_sub_2, &size_2);
+		zassert_not_null(data_1, NULL);
+		zassert_equal(data_1, data_2, "The subscribers should share the payload");
+		zassert_equal(size_1, sizeof(frame), NULL);
+		zassert_equal(size_2, sizeof(frame), NULL);
+		zassert_mem_equal(data_1, frame, sizeof(frame), NULL);
+
+		sub_free(&shared_sub_1, data_1);
+		sub_free(&shared_sub_2, data_2);
+	}
+	PRINTLN("OK");
+}
+
+ZTEST(zerv, test_pub_sub_ring)
+{
+	// A stream of notifications of varying size wraps around the ring many times. They are
+	// received two emissions behind and freed in pairs, every other pair out of order.
+	const size_t sizes[] = {10, 37, 22};
+	uint8_t frame[40];
+	void *held[2];
+	size_t held_cnt = 0;
+	for (int i = 0; i < 150; i++) {
+		memset(frame, i, sizes[i % 3]);
+		int rc = pub_emit(&ring_pub, frame, sizes[i % 3]);
+		zassert_equal(rc, 0, "Failed to emit %d", i);
+		if (i < 2) {
+			continue;
+		}
+
+		zassert_equal(sub_wait(&ring_sub, K_NO_WAIT), 0, NULL);
+		size_t size;
+		void *buf = sub_receive(&ring_sub, &size);
+		zassert_not_null(buf, NULL);
+		zassert_equal(size, sizes[(i - 2) % 3], NULL);
+		memset(frame, i - 2, size);
+		zassert_mem_equal(buf, frame, size, NULL);
+
+		held[held_cnt++] = buf;
+		if (held_cnt == ARRAY_SIZE(held)) {
+			if (i % 4 == 3) {
+				sub_free(&ring_sub, held[1]);
+				sub_free(&ring_sub, held[0]);
+			} else {
+				sub_free(&ring_sub, held[0]);
+				sub_free(&ring_sub, held[1]);
+			}
+			held_cnt = 0;
+		}
+	}
+	PRINTLN("OK");
+}
+
+ZTEST(zerv, test_pub_sub_receive_many)
+{
+	for (uint32_t i = 0; i < 5; i++) {
+		zassert_equal(pub_emit(&batch_pub, &i, sizeof(i)), 0, NULL);
+	}
+
+	// The backlog is taken in batches of at most three notifications.
+	struct sub_view views[3];
+	int cnt = sub_receive_many(&batch_sub, views, ARRAY_SIZE(views), K_NO_WAIT);
+	zassert_equal(cnt, 3, NULL);
+	for (int i = 0; i < cnt; i++) {
+		zassert_equal(views[i].emittor, &batch_pub, NULL);
+		zassert_equal(views[i].size, sizeof(uint32_t), NULL);
+		zassert_equal(*(uint32_t *)views[i].data, i, NULL);
+	}
+	sub_free_many(&batch_sub, views, cnt);
+
+	cnt = sub_receive_many(&batch_sub, views, ARRAY_SIZE(views), K_NO_WAIT);
+	zassert_equal(cnt, 2, NULL);
+	zassert_equal(*(uint32_t *)views[0].data, 3, NULL);
+	zassert_equal(*(uint32_t *)views[1].data, 4, NULL);
+	sub_free_many(&batch_sub, views, cnt);
+
+	cnt = sub_receive_many(&batch_sub, views, ARRAY_SIZE(views), K_NO_WAIT);
+	zassert_equal(cnt, -EAGAIN, NULL);
+	PRINTLN("OK");
+}
+
+ZTEST(zerv, test_sub_wait_any)
+{
+	struct sub *const subs[] = {&any_sub_1, &any_sub_2};
+	struct sub_view view;
+
+	zassert_is_null(sub_wait_any(subs, ARRAY_SIZE(subs), &view, K_MSEC(10)), NULL);
+
+	// The first publisher emits more than the second, which must still be served in turn.
+	for (uint32_t i = 0; i < 4; i++) {
+		zassert_equal(pub_emit(&any_pub_1, &i, sizeof(i)), 0, NULL);
+	}
+	for (uint32_t i = 0; i < 2; i++) {
+		zassert_equal(pub_emit(&any_pub_2, &i, sizeof(i)), 0, NULL);
+	}
+
+	struct sub *const expected[] = {&any_sub_1, &any_sub_2, &any_sub_1,
+					&any_sub_2, &any_sub_1, &any_sub_1};
+	const uint32_t expected_data[] = {0, 0, 1, 1, 2, 3};
+	for (size_t i = 0; i < ARRAY_SIZE(expected); i++) {
+		struct sub *sub = sub_wait_any(subs, ARRAY_SIZE(subs), &view, K_NO_WAIT);
+		zassert_equal_ptr(sub, expected[i], "Unexpected subscriber served at %d", (int)i);
+		zassert_equal(view.emittor, sub == &any_sub_1 ? &any_pub_1 : &any_pub_2, NULL);
+		zassert_equal(*(uint32_t *)view.data, expected_data[i], NULL);
+		sub_free(sub, view.data);
+	}
+
+	zassert_is_null(sub_wait_any(subs, ARRAY_SIZE(subs), &view, K_NO_WAIT), NULL);
+	PRINTLN("OK");
+}
+
+ZTEST(zerv, test_pub_emit_partial_delivery)
+{
+	// The slow subscriber never frees its notifications, so it fills up while the fast one
+	// keeps receiving every emission.
+	size_t delivered = 0;
+	size_t dropped = 0;
+	uint8_t data[16];
+	for (int i = 0; i < 8; i++) {
+		memset(data, i, sizeof(data));
+		struct pub_emit_result result;
+		int rc = pub_emit_with_result(&lossy_pub, data, sizeof(data), &result);
+		zassert_equal(result.delivered + result.dropped, 2, NULL);
+		zassert_true(rc == 0 || rc == -ENOMEM, "Unexpected rc %d", rc);
+		zassert_equal(rc == 0, result.dropped == 0, NULL);
+		delivered += result.delivered;
+		dropped += result.dropped;
+
+		zassert_equal(sub_wait(&lossy_fast_sub, K_NO_WAIT), 0, NULL);
+		uint8_t *recv = sub_receive(&lossy_fast_sub, NULL);
+		zassert_mem_equal(recv, data, sizeof(data), NULL);
+		sub_free(&lossy_fast_sub, recv);
+	}
+
+	struct sub_stats slow;
+	struct sub_stats fast;
+	sub_stats_get(&lossy_slow_sub, &slow);
+	sub_stats_get(&lossy_fast_sub, &fast);
+	zassert_equal(fast.delivered, 8, NULL);
+	zassert_equal(fast.dropped, 0, NULL);
+	zassert_equal(slow.delivered + slow.dropped, 8, NULL);
+	zassert_true(slow.dropped > 0, NULL);
+	zassert_equal(delivered, fast.delivered + slow.delivered, NULL);
+	zassert_equal(dropped, slow.dropped, NULL);
+
+	// Drain the slow subscriber.
+	while (sub_wait(&lossy_slow_sub, K_NO_WAIT) == 0) {
+		sub_free(&lossy_slow_sub, sub_receive(&lossy_slow_sub, NULL));
+	}
+	PRINTLN("OK");
+}
+
+ZTEST(zerv, test_pub_sub_typed)
+{
+	// The queue holds four records, the fifth is dropped.
+	for (int16_t i = 0; i < 5; i++) {
+		struct typed_sample sample = {.x = i, .y = -i, .z = 2 * i};
+		int rc = PUB_EMIT_TYPED(typed_pub, &sample);
+		zassert_equal(rc, i < 4 ? 0 : -ENOMEM, "Unexpected rc %d at %d", rc, i);
+	}
+
+	for (int16_t i = 0; i < 4; i++) {
+		struct typed_sample sample;
+		zassert_equal(SUB_RECEIVE_TYPED(typed_sub, &sample, K_NO_WAIT), 0, NULL);
+		zassert_equal(sample.x, i, NULL);
+		zassert_equal(sample.y, -i, NULL);
+		zassert_equal(sample.z, 2 * i, NULL);
+	}
+	struct typed_sample sample;
+	zassert_equal(SUB_RECEIVE_TYPED(typed_sub, &sample, K_NO_WAIT), -EAGAIN, NULL);
+
+	struct sub_stats stats;
+	sub_stats_get(&typed_sub, &stats);
+	zassert_equal(stats.delivered, 4, NULL);
+	zassert_equal(stats.dropped, 1, NULL);
+
+	// Records of another size are rejected.
+	zassert_equal(pub_add_subscriber(&typed_pub, &typed_byte_sub), -EINVAL, NULL);
+	uint8_t byte = 0;
+	zassert_equal(pub_emit(&typed_pub, &byte, sizeof(byte)), -EINVAL, NULL);
+	zassert_equal(sub_wait(&typed_sub, K_NO_WAIT), -EINVAL, NULL);
+	PRINTLN("OK");
+}
+
+ZTEST(zerv, test_pub_sub_lockfree)
+{
+	// Fill all four slots, the fifth notification is dropped.
+	uint8_t data[16];
+	for (int i = 0; i < 5; i++) {
+		memset(data, i, sizeof(data));
+		int rc = pub_emit(&lockfree_pub, data, sizeof(data));
+		zassert_equal(rc, i < 4 ? 0 : -ENOMEM, "Unexpected rc %d at %d", rc, i);
+	}
+
+	// Notifications larger than a slot are dropped.
+	uint8_t large[32] = {0};
+	zassert_equal(pub_emit(&lockfree_pub, large, sizeof(large)), -ENOMEM, NULL);
+
+	// Freeing out of order returns the slots for reuse.
+	void *bufs[4];
+	for (int i = 0; i < 4; i++) {
+		zassert_equal(sub_wait(&lockfree_sub, K_NO_WAIT), 0, NULL);
+		size_t size;
+		bufs[i] = sub_receive(&lockfree_sub, &size);
+		zassert_equal(size, sizeof(data), NULL);
+		memset(data, i, sizeof(data));
+		zassert_mem_equal(bufs[i], data, sizeof(data), NULL);
+	}
+	sub_free(&lockfree_sub, bufs[2]);
+	sub_free(&lockfree_sub, bufs[0]);
+	sub_free(&lockfree_sub, bufs[3]);
+	sub_free(&lockfree_sub, bufs[1]);
+
+	for (int i = 0; i < 8; i++) {
+		memset(data, 0x10 + i, sizeof(data));
+		zassert_equal(pub_emit(&lockfree_pub, data, sizeof(data)), 0, NULL);
+		zassert_equal(sub_wait(&lockfree_sub, K_NO_WAIT), 0, NULL);
+		uint8_t *buf = sub_receive(&lockfree_sub, NULL);
+		zassert_mem_equal(buf, data, sizeof(data), NULL);
+		sub_free(&lockfree_sub, buf);
+	}
+	zassert_equal(sub_wait(&lockfree_sub, K_NO_WAIT), -EAGAIN, NULL);
+	PRINTLN("OK");
+}
+
+ZTEST(zerv, test_state)
+{
+	struct test_mode mode;
+	zassert_equal(ZERV_STATE_READ(test_mode, &mode), ZERV_RC_OK, NULL);
+	zassert_equal(mode.mode, 0, NULL);
+	zassert_equal(mode.gain, 0, NULL);
+
+	{
+		ZERV_CALL(zerv_test_service, set_test_mode, rc, p_ret, 3, 1000);
+		zassert_equal(rc, ZERV_RC_OK, NULL);
+	}
+
+	// The new value is read directly, without a call to the owning zervice.
+	zassert_equal(ZERV_STATE_READ(test_mode, &mode), ZERV_RC_OK, NULL);
+	zassert_equal(mode.mode, 3, NULL);
+	zassert_equal(mode.gain, 1000, NULL);
+	PRINTLN("OK");
+}
+
+ZTEST(zerv, test_cmd_const)
+{
+	{
+		ZERV_CALL(zerv_test_service, set_test_mode, rc, p_ret, 7, 42);
+		zassert_equal(rc, ZERV_RC_OK, NULL);
+	}
+
+	// The const command sees the state left by the mutating one, and runs on this thread.
+	ZERV_CALL(zerv_test_service, get_test_mode, rc, p_ret);
+	zassert_equal(rc, ZERV_RC_OK, NULL);
+	zassert_equal(p_ret->mode, 7, NULL);
+	zassert_equal(p_ret->gain, 42, NULL);
+	zassert_equal_ptr(get_test_mode_thread, k_current_get(), NULL);
+	PRINTLN("OK");
+}
+
+static uint32_t const_reader_writes;
+
+static void const_reader_thread(void *p1, void *p2, void *p3)
+{
+	ZERV_CALL(const_service, const_read, rc, p_ret);
+	zassert_equal(rc, ZERV_RC_OK, NULL);
+	const_reader_writes = p_ret->writes;
+}
+
+K_THREAD_STACK_DEFINE(const_reader_stack, 1024);
+static struct k_thread const_reader;
+
+ZTEST(zerv, test_cmd_const_excludes_writer)
+{
+	// The reader is in the const command when the mutating command is called.
+	k_thread_create(&const_reader, const_reader_stack,
+			K_THREAD_STACK_SIZEOF(const_reader_stack), const_reader_thread, NULL, NULL,
+			NULL, K_PRIO_PREEMPT(10), 0, K_NO_WAIT);
+	zassert_equal(k_sem_take(&const_read_entered_sem, K_MSEC(100)), 0, NULL);
+
+	// The mutating command waits for the reader to leave before it is handled.
+	ZERV_CALL(const_service, const_write, rc, p_ret);
+	zassert_equal(rc, ZERV_RC_OK, NULL);
+	zassert_equal(p_ret->readers, 0, "The writer overlapped the reader");
+
+	k_thread_join(&const_reader, K_FOREVER);
+	zassert_equal(const_reader_writes, 0, "The state was written under the reader");
+	PRINTLN("OK");
+}
+
+ZTEST(zerv, test_pooled)
+{
+	// The init callback is called by a worker at boot.
+	zassert_equal(k_sem_take(&pooled_init_sem, K_MSEC(100)), 0, NULL);
+
+	// The idle zervice is handled by the other worker while the first one is in a handler.
+	for (uint32_t i = 0; i < 16; i++) {
+		ZERV_MSG(pooled_service, pooled_work, rc, 1);
+		zassert_equal(rc, ZERV_RC_OK, NULL);
+		ZERV_MSG(pooled_idle_service, pooled_ping, ping_rc, i);
+		zassert_equal(ping_rc, ZERV_RC_OK, NULL);
+	}
+	for (uint32_t i = 0; i < 16; i++) {
+		zassert_equal(k_sem_take(&pooled_ping_sem, K_MSEC(100)), 0, NULL);
+	}
+
+	// The command is queued behind the messages, which have all been handled one at a time.
+	ZERV_CALL(pooled_service, pooled_stats, rc, p_ret);
+	zassert_equal(rc, ZERV_RC_OK, NULL);
+	zassert_equal(p_ret->handled, 16, NULL);
+	zassert_equal(p_ret->overlaps, 0, NULL);
+	zassert_true(p_ret->pings_during_work > 0, "The zervices were not handled in parallel");
+	PRINTLN("OK");
+}
+
+ZTEST(zerv, test_workq)
+{
+	// More messages than are handled per run of the work item.
+	for (uint32_t i = 0; i < 10; i++) {
+		ZERV_MSG(workq_service, workq_count, rc, i);
+		zassert_equal(rc, ZERV_RC_OK, NULL);
+	}
+
+	// The command is queued behind the messages and handled on the system work queue.
+	ZERV_CALL(workq_service, workq_echo, rc, p_ret, 42);
+	zassert_equal(rc, ZERV_RC_OK, NULL);
+	zassert_equal(p_ret->n, 42, NULL);
+	zassert_equal(p_ret->handled, 10, NULL);
+	zassert_equal_ptr(workq_echo_thread, &k_sys_work_q.thread, NULL);
+	PRINTLN("OK");
+}
+
+ZTEST(zerv, test_cmd_async)
+{
+	// async_front awaits async_back, which calls async_front back while it awaits.
+	{
+		ZERV_CALL(async_front, async_sum, rc, p_ret, 5, 3);
+		zassert_equal(rc, ZERV_RC_OK, NULL);
+		zassert_equal(p_ret->sum, 5 + 3 * 10 + 1, NULL);
+	}
+
+	// The continuation starts over on the next call.
+	{
+		ZERV_CALL(async_front, async_sum, rc, p_ret, 1, 2);
+		zassert_equal(rc, ZERV_RC_OK, NULL);
+		zassert_equal(p_ret->sum, 1 + 2 * 10 + 1, NULL);
+	}
+	PRINTLN("OK");
+}
+
+ZTEST(zerv, test_cmd_async_prio)
+{
+	// The zervice inherits the priority of the test thread while the call awaits async_back.
+	ZERV_CALL(async_front, async_sum, rc, p_ret, 5, 3);
+	zassert_equal(rc, ZERV_RC_OK, NULL);
+
+	// The zervice drops the inherited priority once it is done with the request.
+	k_msleep(10);
+	zassert_equal(k_thread_priority_get(async_front_tid), ASYNC_FRONT_PRIO,
+		      "The zervice kept the inherited priority");
+	PRINTLN("OK");
+}
+
+static void repl_client_thread(void *p1, void *p2, void *p3)
+{
+	for (uint32_t i = 0; i < 8; i++) {
+		ZERV_CALL(replicated_service, repl_work, rc, p_ret, i);
+		zassert_equal(rc, ZERV_RC_OK, NULL);
+		zassert_equal(p_ret->n, i, NULL);
+	}
+}
+
+K_THREAD_STACK_DEFINE(repl_client_stack, 1024);
+static struct k_thread repl_client;
+
+ZTEST(zerv, test_replicated)
+{
+	// Parallel calls from two clients interleaved with exclusive messages.
+	k_thread_create(&repl_client, repl_client_stack, K_THREAD_STACK_SIZEOF(repl_client_stack),
+			repl_client_thread, NULL, NULL, NULL, K_PRIO_PREEMPT(10), 0, K_NO_WAIT);
+	for (uint32_t i = 0; i < 8; i++) {
+		ZERV_MSG(replicated_service, repl_seq, msg_rc, i);
+		zassert_equal(msg_rc, ZERV_RC_OK, NULL);
+		ZERV_CALL(replicated_service, repl_work, rc, p_ret, i);
+		zassert_equal(rc, ZERV_RC_OK, NULL);
+	}
+	k_thread_join(&repl_client, K_FOREVER);
+
+	// The messages were handled one at a time and in the order they were sent.
+	ZERV_CALL(replicated_service, repl_stats, rc, p_ret);
+	zassert_equal(rc, ZERV_RC_OK, NULL);
+	zassert_equal(p_ret->handled, 8, NULL);
+	zassert_equal(p_ret->reordered, 0, NULL);
+	zassert_equal(p_ret->overlaps, 0, NULL);
+	PRINTLN("OK");
+}
+
+ZTEST(zerv, test_sharded)
+{
+	// Every key is handled by the shard picked by the key, and keeps its value there.
+	for (uint32_t key = 0; key < SHARDED_KEY_CNT; key++) {
+		ZERV_CALL(sharded_service, shard_put, rc, p_ret, key, key * 10);
+		zassert_equal(rc, ZERV_RC_OK, NULL);
+		zassert_equal(p_ret->shard, key % 2, NULL);
+	}
+	for (uint32_t key = 0; key < SHARDED_KEY_CNT; key++) {
+		ZERV_CALL(sharded_service, shard_get, rc, p_ret, key);
+		zassert_equal(rc, ZERV_RC_OK, NULL);
+		zassert_equal(p_ret->shard, key % 2, NULL);
+		zassert_equal(p_ret->value, key * 10, NULL);
+	}
+
+	// A message goes to the shard of its key, ahead of the next call with the same key.
+	{
+		ZERV_MSG(sharded_service, shard_clear, rc, 3);
+		zassert_equal(rc, ZERV_RC_OK, NULL);
+	}
+	{
+		ZERV_CALL(sharded_service, shard_get, rc, p_ret, 3);
+		zassert_equal(rc, ZERV_RC_OK, NULL);
+		zassert_equal(p_ret->value, 0, NULL);
+	}
+
+	// The test thread is not one of the shards.
+	zassert_equal(zerv_shard_index(&sharded_service), -1, NULL);
+
+	// The prerequisites of the sharded zervice are waited for by each of its shards.
+	zassert_equal(atomic_get(&sharded_early_inits), 0, NULL);
+	PRINTLN("OK");
+}
+
+#define PRIO_HIGH K_PRIO_PREEMPT(2)
+#define PRIO_MEDIUM K_PRIO_PREEMPT(8)
+#define PRIO_WORK_US 2000
+#define PRIO_HOG_MS 50
+
+K_THREAD_STACK_DEFINE(prio_high_stack, 1024);
+K_THREAD_STACK_DEFINE(prio_medium_stack, 512);
+static struct k_thread prio_high;
+static struct k_thread prio_medium;
+static zerv_rc_t prio_rc;
+static int prio_inherited;
+static int prio_after;
+static uint32_t prio_latency_us;
+
+// Keeps the CPU busy at a priority between the caller and the zervice.
+static void prio_medium_thread(void *p1, void *p2, void *p3)
+{
+	k_busy_wait(PRIO_HOG_MS * 1000);
+}
+
+static void prio_high_thread(void *p1, void *p2, void *p3)
+{
+	// The medium thread is ready to run as soon as the call blocks this thread.
+	k_thread_create(&prio_medium, prio_medium_stack, K_THREAD_STACK_SIZEOF(prio_medium_stack),
+			prio_medium_thread, NULL, NULL, NULL, PRIO_MEDIUM, 0, K_NO_WAIT);
+
+	uint32_t start = k_cycle_get_32();
+	ZERV_CALL(prio_service, prio_work, rc, p_ret, PRIO_WORK_US);
+	prio_latency_us = k_cyc_to_us_near32(k_cycle_get_32() - start);
+	prio_rc = rc;
+	prio_inherited = p_ret->prio;
+	prio_after = k_thread_priority_get(prio_service_tid);
+}
+
+ZTEST(zerv, test_prio_inherit)
+{
+	// Without inheritance the zervice would wait for the medium thread to finish first.
+	k_thread_create(&prio_high, prio_high_stack, K_THREAD_STACK_SIZEOF(prio_high_stack),
+			prio_high_thread, NULL, NULL, NULL, PRIO_HIGH, 0, K_NO_WAIT);
+	k_thread_join(&prio_high, K_FOREVER);
+	k_thread_join(&prio_medium, K_FOREVER);
+
+	PRINTLN("Call latency %u us with the medium thread ready", prio_latency_us);
+	zassert_equal(prio_rc, ZERV_RC_OK, NULL);
+	zassert_equal(prio_inherited, PRIO_HIGH, "The zervice did not inherit the caller priority");
+	zassert_equal(prio_after, PRIO_SERVICE_PRIO, "The zervice kept the inherited priority");
+	zassert_true(prio_latency_us < PRIO_HOG_MS * 500, "The call waited for the medium thread");
+	PRINTLN("OK");
+}
+
+ZTEST(zerv, test_lazy_start)
+{
+	// Nothing has been sent to the zervice yet, so it has not been initialized.
+	zassert_equal(lazy_init_cnt, 0, "The lazy zervice was started at boot");
+
+	// The topic event starts the zervice, and the messages are queued while it initializes.
+	zerv_rc_t rc = ZERV_TOPIC_EMIT(lazy_topic, 5);
+	zassert_equal(rc, ZERV_RC_OK, NULL);
+	for (int i = 0; i < 3; i++) {
+		ZERV_MSG(lazy_service, lazy_ping, msg_rc, i);
+		zassert_equal(msg_rc, ZERV_RC_OK, NULL);
+	}
+
+	ZERV_CALL(lazy_service, lazy_stats, call_rc, p_ret);
+	zassert_equal(call_rc, ZERV_RC_OK, NULL);
+	zassert_equal(p_ret->init_cnt, 1, NULL);
+	zassert_equal(p_ret->topic_sum, 5, NULL);
+	zassert_equal(p_ret->ping_cnt, 3, "Requests sent during the init were lost or reordered");
+	PRINTLN("OK");
+}
+
+ZTEST(zerv, test_init_pooled_chain)
+{
+	// The pooled zervices waiting for their prerequisites do not hold the workers, which run
+	// chain_c first.
+	ZERV_CALL(chain_a, chain_order, rc, p_ret);
+	zassert_equal(rc, ZERV_RC_OK, NULL);
+	zassert_equal(p_ret->c, 1, NULL);
+	zassert_equal(p_ret->b, 2, NULL);
+	zassert_equal(p_ret->a, 3, NULL);
+	PRINTLN("OK");
+}
+
+ZTEST(zerv, test_init_order)
+{
+	// The zervices are ready, as test_main waited for them before the tests.
+	zassert_equal(boot_ready_rc, ZERV_RC_OK, "The zervices failed to initialize: %s",
+		      zerv_rc_to_str(boot_ready_rc));
+	ZERV_CALL(init_top, init_order, rc, p_ret);
+	zassert_equal(rc, ZERV_RC_OK, NULL);
+	zassert_equal(p_ret->violations, 0, "A zervice was initialized before its prerequisites");
+
+	// init_left and init_right are initialized at the same time, so init_top waits for two
+	// initializations rather than three.
+	zassert_true(p_ret->span_ms >= 2 * INIT_SERVICE_MS, NULL);
+	zassert_true(p_ret->span_ms < 3 * INIT_SERVICE_MS, "The prerequisites ran in turn");
+	PRINTLN("OK");
 }
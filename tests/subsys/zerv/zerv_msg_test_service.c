@@ -6,11 +6,21 @@
 K_SEM_DEFINE(print_msg_sem, 0, 1);
 K_SEM_DEFINE(cmp_msg_1_sem, 0, 1);
 K_SEM_DEFINE(cmp_msg_2_sem, 0, 1);
+K_SEM_DEFINE(test_topic_sem, 0, 3);
+K_SEM_DEFINE(batch_topic_sem, 0, 8);
+
+int batch_topic_sample_sum;
 
 LOG_MODULE_REGISTER(zerv_msg_test_service, LOG_LEVEL_DBG);
 
 ZERV_DEF_THREAD(zerv_msg_test_service, 512, 2048, K_PRIO_PREEMPT(10), NULL);
 ZERV_TOPIC_DEF(test_topic);
+ZERV_TOPIC_DEF_HISTORY(history_topic, 4);
+ZERV_TOPIC_DEF_PATH(imu0_accel, "sensors/imu/0/accel");
+ZERV_TOPIC_DEF_PATH(imu1_accel, "sensors/imu/1/accel");
+ZERV_TOPIC_DEF_PATH(imu0_gyro, "sensors/imu/0/gyro");
+ZERV_TOPIC_PATTERN_DEF(any_imu_accel, "sensors/imu/+/accel");
+ZERV_TOPIC_DEF(batch_topic);
 
 ZERV_MSG_HANDLER_DEF(print_msg, param)
 {
@@ -52,4 +62,11 @@ ZERV_CMD_HANDLER_DEF(emit_on_test_topic, in, out)
 	LOG_INF("emit_on_test_topic: a=%d, b=%u, c=%c", in->a, in->b, in->c);
 	ZERV_TOPIC_EMIT(test_topic, in->a, in->b, in->c);
 	return 0;
-}
\ No newline at end of file
+}
+
+ZERV_TOPIC_HANDLER(zerv_msg_test_service, batch_topic, msg)
+{
+	LOG_INF("batch_topic: sample=%d", msg->sample);
+	batch_topic_sample_sum += msg->sample;
+	k_sem_give(&batch_topic_sem);
+}
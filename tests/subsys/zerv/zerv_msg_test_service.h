@@ -9,6 +9,9 @@
 extern struct k_sem print_msg_sem;
 extern struct k_sem cmp_msg_1_sem;
 extern struct k_sem cmp_msg_2_sem;
+extern struct k_sem test_topic_sem;
+extern struct k_sem batch_topic_sem;
+extern int batch_topic_sample_sum;
 
 ZERV_MSG_DECL(print_msg, char msg[15]);
 ZERV_MSG_DECL(cmp_msg_1, int a, unsigned int b, char c, char d[15]);
@@ -18,8 +21,21 @@ ZERV_MSG_RAW_DECL(raw_msg);
 ZERV_CMD_DECL(emit_on_test_topic, ZERV_IN(int a, unsigned int b, char c), ZERV_OUT_EMPTY);
 ZERV_TOPIC_DECL(test_topic, int a, unsigned int b, char c);
 
+// Topic that keeps the last events for late subscribers to replay.
+ZERV_TOPIC_DECL(history_topic, int seq);
+
+// Topics placed in the hierarchical namespace, and a pattern matching the accelerometer topics.
+ZERV_TOPIC_DECL(imu0_accel, int imu, int value);
+ZERV_TOPIC_DECL(imu1_accel, int imu, int value);
+ZERV_TOPIC_DECL(imu0_gyro, int imu, int value);
+ZERV_TOPIC_DECL(any_imu_accel, int imu, int value);
+
+// Topic emitted in blocks of samples.
+ZERV_TOPIC_DECL(batch_topic, int sample);
+
 // Declare the service.
 ZERV_DECL(zerv_msg_test_service, ZERV_CMDS(emit_on_test_topic),
-	  ZERV_MSGS(print_msg, cmp_msg_1, cmp_msg_2, raw_msg), EMPTY);
+	  ZERV_MSGS(print_msg, cmp_msg_1, cmp_msg_2, raw_msg),
+	  ZERV_SUBSCRIBED_TOPICS(batch_topic));
 
 #endif // _ZERV_MSG_TEST_SERVICE_H_
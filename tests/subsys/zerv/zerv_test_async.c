@@ -0,0 +1,60 @@
+/*=================================================================================================
+ *
+ *           ██████╗ ██╗████████╗███╗   ███╗ █████╗ ███╗   ██╗     █████╗ ██████╗
+ *           ██╔══██╗██║╚══██╔══╝████╗ ████║██╔══██╗████╗  ██║    ██╔══██╗██╔══██╗
+ *           ██████╔╝██║   ██║   ██╔████╔██║███████║██╔██╗ ██║    ███████║██████╔╝
+ *           ██╔══██╗██║   ██║   ██║╚██╔╝██║██╔══██║██║╚██╗██║    ██╔══██║██╔══██╗
+ *           ██████╔╝██║   ██║   ██║ ╚═╝ ██║██║  ██║██║ ╚████║    ██║  ██║██████╔╝
+ *           ╚═════╝ ╚═╝   ╚═╝   ╚═╝     ╚═╝╚═╝  ╚═╝╚═╝  ╚═══╝    ╚═╝  ╚═╝╚═════╝
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * Copyright (c) 2023 BitMan AB
+ * contact: albin@bitman.se
+ *===============================================================================================*/
+#include "zerv_test_async.h"
+
+#include <zephyr/logging/log.h>
+
+LOG_MODULE_REGISTER(async, CONFIG_ZERV_LOG_LEVEL);
+
+k_tid_t async_front_tid;
+
+static int async_front_init(void)
+{
+	async_front_tid = k_current_get();
+	return 0;
+}
+
+ZERV_DEF_THREAD(async_front, 512, 1024, ASYNC_FRONT_PRIO, async_front_init);
+ZERV_DEF_THREAD(async_back, 512, 1024, K_PRIO_PREEMPT(10), NULL);
+
+ZERV_CMD_ASYNC_HANDLER_DEF(async_sum, in, out)
+{
+	static async_lookup_ret_t lookup;
+	zerv_rc_t rc;
+
+	ZERV_ASYNC_BEGIN();
+	ZERV_AWAIT_CALL(async_back, async_lookup, rc, &lookup, in->key);
+	if (rc != ZERV_RC_OK) {
+		return rc;
+	}
+	out->sum = in->a + lookup.value;
+	ZERV_ASYNC_END(ZERV_RC_OK);
+}
+
+ZERV_CMD_HANDLER_DEF(async_scale, in, out)
+{
+	out->value = in->key * 10;
+	return 0;
+}
+
+ZERV_CMD_HANDLER_DEF(async_lookup, in, out)
+{
+	// A blocking call back to the zervice awaiting this command.
+	ZERV_CALL(async_front, async_scale, rc, p_ret, in->key);
+	if (rc != ZERV_RC_OK) {
+		return rc;
+	}
+	out->value = p_ret->value + 1;
+	return 0;
+}
@@ -0,0 +1,33 @@
+/*=================================================================================================
+ *
+ *           ██████╗ ██╗████████╗███╗   ███╗ █████╗ ███╗   ██╗     █████╗ ██████╗
+ *           ██╔══██╗██║╚══██╔══╝████╗ ████║██╔══██╗████╗  ██║    ██╔══██╗██╔══██╗
+ *           ██████╔╝██║   ██║   ██╔████╔██║███████║██╔██╗ ██║    ███████║██████╔╝
+ *           ██╔══██╗██║   ██║   ██║╚██╔╝██║██╔══██║██║╚██╗██║    ██╔══██║██╔══██╗
+ *           ██████╔╝██║   ██║   ██║ ╚═╝ ██║██║  ██║██║ ╚████║    ██║  ██║██████╔╝
+ *           ╚═════╝ ╚═╝   ╚═╝   ╚═╝     ╚═╝╚═╝  ╚═╝╚═╝  ╚═══╝    ╚═╝  ╚═╝╚═════╝
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * Copyright (c) 2023 BitMan AB
+ * contact: albin@bitman.se
+ *===============================================================================================*/
+#ifndef _ZERV_TEST_ASYNC_H_
+#define _ZERV_TEST_ASYNC_H_
+
+#include <zephyr/kernel.h>
+#include <zephyr/zerv/zerv.h>
+#include <zephyr/zerv/zerv_cmd.h>
+
+// Awaits async_lookup on async_back, which calls async_scale back on async_front meanwhile.
+ZERV_CMD_DECL(async_sum, ZERV_IN(int32_t a, int32_t key), ZERV_OUT(int32_t sum));
+ZERV_CMD_DECL(async_scale, ZERV_IN(int32_t key), ZERV_OUT(int32_t value));
+ZERV_CMD_DECL(async_lookup, ZERV_IN(int32_t key), ZERV_OUT(int32_t value));
+
+ZERV_DECL(async_front, ZERV_CMDS(async_sum, async_scale), EMPTY, EMPTY);
+ZERV_DECL(async_back, ZERV_CMDS(async_lookup), EMPTY, EMPTY);
+
+#define ASYNC_FRONT_PRIO K_PRIO_PREEMPT(10)
+
+extern k_tid_t async_front_tid;
+
+#endif /* _ZERV_TEST_ASYNC_H_ */
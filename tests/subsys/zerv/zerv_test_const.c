@@ -0,0 +1,46 @@
+/*=================================================================================================
+ *
+ *           ██████╗ ██╗████████╗███╗   ███╗ █████╗ ███╗   ██╗     █████╗ ██████╗
+ *           ██╔══██╗██║╚══██╔══╝████╗ ████║██╔══██╗████╗  ██║    ██╔══██╗██╔══██╗
+ *           ██████╔╝██║   ██║   ██╔████╔██║███████║██╔██╗ ██║    ███████║██████╔╝
+ *           ██╔══██╗██║   ██║   ██║╚██╔╝██║██╔══██║██║╚██╗██║    ██╔══██║██╔══██╗
+ *           ██████╔╝██║   ██║   ██║ ╚═╝ ██║██║  ██║██║ ╚████║    ██║  ██║██████╔╝
+ *           ╚═════╝ ╚═╝   ╚═╝   ╚═╝     ╚═╝╚═╝  ╚═╝╚═╝  ╚═══╝    ╚═╝  ╚═╝╚═════╝
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * Copyright (c) 2023 BitMan AB
+ * contact: albin@bitman.se
+ *===============================================================================================*/
+#include "zerv_test_const.h"
+
+#include <zephyr/logging/log.h>
+
+LOG_MODULE_REGISTER(const_test, CONFIG_ZERV_LOG_LEVEL);
+
+K_SEM_DEFINE(const_read_entered_sem, 0, 1);
+
+static atomic_t const_readers = ATOMIC_INIT(0);
+static uint32_t const_writes = 0;
+
+ZERV_DEF_THREAD(const_service, 256, 1024, K_PRIO_PREEMPT(5), NULL);
+
+ZERV_CMD_HANDLER_DEF(const_read, in, out)
+{
+	atomic_inc(&const_readers);
+	k_sem_give(&const_read_entered_sem);
+
+	// A writer let in meanwhile would change the state under the reader.
+	uint32_t writes = const_writes;
+	k_msleep(CONST_READ_MS);
+	out->writes = const_writes - writes;
+
+	atomic_dec(&const_readers);
+	return 0;
+}
+
+ZERV_CMD_HANDLER_DEF(const_write, in, out)
+{
+	out->readers = atomic_get(&const_readers);
+	const_writes++;
+	return 0;
+}
@@ -0,0 +1,33 @@
+/*=================================================================================================
+ *
+ *           ██████╗ ██╗████████╗███╗   ███╗ █████╗ ███╗   ██╗     █████╗ ██████╗
+ *           ██╔══██╗██║╚══██╔══╝████╗ ████║██╔══██╗████╗  ██║    ██╔══██╗██╔══██╗
+ *           ██████╔╝██║   ██║   ██╔████╔██║███████║██╔██╗ ██║    ███████║██████╔╝
+ *           ██╔══██╗██║   ██║   ██║╚██╔╝██║██╔══██║██║╚██╗██║    ██╔══██║██╔══██╗
+ *           ██████╔╝██║   ██║   ██║ ╚═╝ ██║██║  ██║██║ ╚████║    ██║  ██║██████╔╝
+ *           ╚═════╝ ╚═╝   ╚═╝   ╚═╝     ╚═╝╚═╝  ╚═╝╚═╝  ╚═══╝    ╚═╝  ╚═╝╚═════╝
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * Copyright (c) 2023 BitMan AB
+ * contact: albin@bitman.se
+ *===============================================================================================*/
+#ifndef _ZERV_TEST_CONST_H_
+#define _ZERV_TEST_CONST_H_
+
+#include <zephyr/kernel.h>
+#include <zephyr/zerv/zerv.h>
+#include <zephyr/zerv/zerv_cmd.h>
+
+// The time the const command stays in its handler.
+#define CONST_READ_MS 20
+
+// Given once the const command has entered its handler.
+extern struct k_sem const_read_entered_sem;
+
+// A const command that is slow to read the state, and a command writing it.
+ZERV_CMD_DECL_CONST(const_read, ZERV_IN_EMPTY, ZERV_OUT(uint32_t writes));
+ZERV_CMD_DECL(const_write, ZERV_IN_EMPTY, ZERV_OUT(uint32_t readers));
+
+ZERV_DECL(const_service, ZERV_CMDS(const_read, const_write), EMPTY, EMPTY);
+
+#endif /* _ZERV_TEST_CONST_H_ */
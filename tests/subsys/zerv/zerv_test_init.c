@@ -0,0 +1,120 @@
+/*=================================================================================================
+ *
+ *           ██████╗ ██╗████████╗███╗   ███╗ █████╗ ███╗   ██╗     █████╗ ██████╗
+ *           ██╔══██╗██║╚══██╔══╝████╗ ████║██╔══██╗████╗  ██║    ██╔══██╗██╔══██╗
+ *           ██████╔╝██║   ██║   ██╔████╔██║███████║██╔██╗ ██║    ███████║██████╔╝
+ *           ██╔══██╗██║   ██║   ██║╚██╔╝██║██╔══██║██║╚██╗██║    ██╔══██║██╔══██╗
+ *           ██████╔╝██║   ██║   ██║ ╚═╝ ██║██║  ██║██║ ╚████║    ██║  ██║██████╔╝
+ *           ╚═════╝ ╚═╝   ╚═╝   ╚═╝     ╚═╝╚═╝  ╚═╝╚═╝  ╚═══╝    ╚═╝  ╚═╝╚═════╝
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * Copyright (c) 2023 BitMan AB
+ * contact: albin@bitman.se
+ *===============================================================================================*/
+#include "zerv_test_init.h"
+
+#include <zephyr/logging/log.h>
+
+LOG_MODULE_REGISTER(init, CONFIG_ZERV_LOG_LEVEL);
+
+atomic_t init_base_done;
+
+static atomic_t init_violations;
+static atomic_t left_done;
+static atomic_t right_done;
+static int64_t base_start_ms;
+static int64_t top_start_ms;
+
+static int init_base_init(void)
+{
+	base_start_ms = k_uptime_get();
+	k_msleep(INIT_SERVICE_MS);
+	atomic_set(&init_base_done, 1);
+	return 0;
+}
+
+static int init_left_init(void)
+{
+	if (!atomic_get(&init_base_done)) {
+		atomic_inc(&init_violations);
+	}
+	k_msleep(INIT_SERVICE_MS);
+	atomic_set(&left_done, 1);
+	return 0;
+}
+
+static int init_right_init(void)
+{
+	if (!atomic_get(&init_base_done)) {
+		atomic_inc(&init_violations);
+	}
+	k_msleep(INIT_SERVICE_MS);
+	atomic_set(&right_done, 1);
+	return 0;
+}
+
+static int init_top_init(void)
+{
+	top_start_ms = k_uptime_get();
+	if (!atomic_get(&left_done) || !atomic_get(&right_done)) {
+		atomic_inc(&init_violations);
+	}
+	return 0;
+}
+
+// The zervices are defined in the reverse order of their initialization.
+ZERV_DEF_THREAD(init_top, 256, 1024, K_PRIO_PREEMPT(10), init_top_init);
+ZERV_DEF_THREAD(init_right, 256, 1024, K_PRIO_PREEMPT(10), init_right_init);
+ZERV_DEF_THREAD(init_left, 256, 1024, K_PRIO_PREEMPT(10), init_left_init);
+ZERV_DEF_THREAD(init_base, 256, 1024, K_PRIO_PREEMPT(10), init_base_init);
+
+ZERV_INIT_AFTER(init_left, init_base);
+ZERV_INIT_AFTER(init_right, init_base);
+ZERV_INIT_AFTER(init_top, init_left, init_right);
+
+static atomic_t chain_seq;
+static int chain_a_seq;
+static int chain_b_seq;
+static int chain_c_seq;
+
+static int chain_a_init(void)
+{
+	chain_a_seq = atomic_inc(&chain_seq) + 1;
+	return 0;
+}
+
+static int chain_b_init(void)
+{
+	chain_b_seq = atomic_inc(&chain_seq) + 1;
+	return 0;
+}
+
+static int chain_c_init(void)
+{
+	k_msleep(INIT_SERVICE_MS);
+	chain_c_seq = atomic_inc(&chain_seq) + 1;
+	return 0;
+}
+
+// The dependents are scheduled to the pool first, so they reach the workers before chain_c.
+ZERV_DEF_POOLED(chain_a, 256, chain_a_init);
+ZERV_DEF_POOLED(chain_b, 256, chain_b_init);
+ZERV_DEF_POOLED(chain_c, 256, chain_c_init);
+
+ZERV_INIT_AFTER(chain_a, chain_b);
+ZERV_INIT_AFTER(chain_b, chain_c);
+
+ZERV_CMD_HANDLER_DEF(chain_order, in, out)
+{
+	out->a = chain_a_seq;
+	out->b = chain_b_seq;
+	out->c = chain_c_seq;
+	return 0;
+}
+
+ZERV_CMD_HANDLER_DEF(init_order, in, out)
+{
+	out->violations = atomic_get(&init_violations);
+	out->span_ms = top_start_ms - base_start_ms;
+	return 0;
+}
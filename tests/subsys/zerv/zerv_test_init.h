@@ -0,0 +1,45 @@
+/*=================================================================================================
+ *
+ *           ██████╗ ██╗████████╗███╗   ███╗ █████╗ ███╗   ██╗     █████╗ ██████╗
+ *           ██╔══██╗██║╚══██╔══╝████╗ ████║██╔══██╗████╗  ██║    ██╔══██╗██╔══██╗
+ *           ██████╔╝██║   ██║   ██╔████╔██║███████║██╔██╗ ██║    ███████║██████╔╝
+ *           ██╔══██╗██║   ██║   ██║╚██╔╝██║██╔══██║██║╚██╗██║    ██╔══██║██╔══██╗
+ *           ██████╔╝██║   ██║   ██║ ╚═╝ ██║██║  ██║██║ ╚████║    ██║  ██║██████╔╝
+ *           ╚═════╝ ╚═╝   ╚═╝   ╚═╝     ╚═╝╚═╝  ╚═╝╚═╝  ╚═══╝    ╚═╝  ╚═╝╚═════╝
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * Copyright (c) 2023 BitMan AB
+ * contact: albin@bitman.se
+ *===============================================================================================*/
+#ifndef _ZERV_TEST_INIT_H_
+#define _ZERV_TEST_INIT_H_
+
+#include <zephyr/kernel.h>
+#include <zephyr/zerv/zerv.h>
+#include <zephyr/zerv/zerv_cmd.h>
+
+// The time each zervice spends in its initialization.
+#define INIT_SERVICE_MS 20
+
+// Set once init_base has been initialized.
+extern atomic_t init_base_done;
+
+ZERV_CMD_DECL(init_order, ZERV_IN_EMPTY, ZERV_OUT(int violations, int64_t span_ms));
+
+// A diamond of zervices, where init_left and init_right are initialized after init_base, and
+// init_top after both of them.
+ZERV_DECL(init_base, EMPTY, EMPTY, EMPTY);
+ZERV_DECL(init_left, EMPTY, EMPTY, EMPTY);
+ZERV_DECL(init_right, EMPTY, EMPTY, EMPTY);
+ZERV_DECL(init_top, ZERV_CMDS(init_order), EMPTY, EMPTY);
+
+// The order the pooled zervices of the chain were initialized in, starting from 1.
+ZERV_CMD_DECL(chain_order, ZERV_IN_EMPTY, ZERV_OUT(int a, int b, int c));
+
+// A chain of pooled zervices, where chain_a is initialized after chain_b and chain_b after
+// chain_c. There are more of them than workers in the pool.
+ZERV_DECL(chain_a, ZERV_CMDS(chain_order), EMPTY, EMPTY);
+ZERV_DECL(chain_b, EMPTY, EMPTY, EMPTY);
+ZERV_DECL(chain_c, EMPTY, EMPTY, EMPTY);
+
+#endif /* _ZERV_TEST_INIT_H_ */
@@ -0,0 +1,54 @@
+/*=================================================================================================
+ *
+ *           ██████╗ ██╗████████╗███╗   ███╗ █████╗ ███╗   ██╗     █████╗ ██████╗
+ *           ██╔══██╗██║╚══██╔══╝████╗ ████║██╔══██╗████╗  ██║    ██╔══██╗██╔══██╗
+ *           ██████╔╝██║   ██║   ██╔████╔██║███████║██╔██╗ ██║    ███████║██████╔╝
+ *           ██╔══██╗██║   ██║   ██║╚██╔╝██║██╔══██║██║╚██╗██║    ██╔══██║██╔══██╗
+ *           ██████╔╝██║   ██║   ██║ ╚═╝ ██║██║  ██║██║ ╚████║    ██║  ██║██████╔╝
+ *           ╚═════╝ ╚═╝   ╚═╝   ╚═╝     ╚═╝╚═╝  ╚═╝╚═╝  ╚═══╝    ╚═╝  ╚═╝╚═════╝
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * Copyright (c) 2023 BitMan AB
+ * contact: albin@bitman.se
+ *===============================================================================================*/
+#include "zerv_test_lazy.h"
+
+#include <zephyr/logging/log.h>
+
+LOG_MODULE_REGISTER(lazy, CONFIG_ZERV_LOG_LEVEL);
+
+int lazy_init_cnt;
+static int lazy_topic_sum;
+static int lazy_ping_cnt;
+
+static int lazy_service_init(void)
+{
+	// A slow initialization, which the requests sent meanwhile wait for.
+	lazy_init_cnt++;
+	k_msleep(20);
+	return 0;
+}
+
+ZERV_TOPIC_DEF(lazy_topic);
+
+ZERV_DEF_THREAD_LAZY(lazy_service, 512, 1024, K_PRIO_PREEMPT(10), lazy_service_init);
+
+ZERV_CMD_HANDLER_DEF(lazy_stats, in, out)
+{
+	out->init_cnt = lazy_init_cnt;
+	out->topic_sum = lazy_topic_sum;
+	out->ping_cnt = lazy_ping_cnt;
+	return 0;
+}
+
+ZERV_MSG_HANDLER_DEF(lazy_ping, msg)
+{
+	if (msg->seq == lazy_ping_cnt) {
+		lazy_ping_cnt++;
+	}
+}
+
+ZERV_TOPIC_HANDLER(lazy_service, lazy_topic, event)
+{
+	lazy_topic_sum += event->value;
+}
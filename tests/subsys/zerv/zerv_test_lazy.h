@@ -0,0 +1,35 @@
+/*=================================================================================================
+ *
+ *           ██████╗ ██╗████████╗███╗   ███╗ █████╗ ███╗   ██╗     █████╗ ██████╗
+ *           ██╔══██╗██║╚══██╔══╝████╗ ████║██╔══██╗████╗  ██║    ██╔══██╗██╔══██╗
+ *           ██████╔╝██║   ██║   ██╔████╔██║███████║██╔██╗ ██║    ███████║██████╔╝
+ *           ██╔══██╗██║   ██║   ██║╚██╔╝██║██╔══██║██║╚██╗██║    ██╔══██║██╔══██╗
+ *           ██████╔╝██║   ██║   ██║ ╚═╝ ██║██║  ██║██║ ╚████║    ██║  ██║██████╔╝
+ *           ╚═════╝ ╚═╝   ╚═╝   ╚═╝     ╚═╝╚═╝  ╚═╝╚═╝  ╚═══╝    ╚═╝  ╚═╝╚═════╝
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * Copyright (c) 2023 BitMan AB
+ * contact: albin@bitman.se
+ *===============================================================================================*/
+#ifndef _ZERV_TEST_LAZY_H_
+#define _ZERV_TEST_LAZY_H_
+
+#include <zephyr/kernel.h>
+#include <zephyr/zerv/zerv.h>
+#include <zephyr/zerv/zerv_cmd.h>
+#include <zephyr/zerv/zerv_msg.h>
+#include <zephyr/zerv/zerv_topic.h>
+
+ZERV_TOPIC_DECL(lazy_topic, int value);
+
+ZERV_CMD_DECL(lazy_stats, ZERV_IN_EMPTY,
+	      ZERV_OUT(int init_cnt, int topic_sum, int ping_cnt));
+ZERV_MSG_DECL(lazy_ping, int seq);
+
+// A zervice whose thread is only started by the first request or topic event.
+ZERV_DECL(lazy_service, ZERV_CMDS(lazy_stats), ZERV_MSGS(lazy_ping),
+	  ZERV_SUBSCRIBED_TOPICS(lazy_topic));
+
+extern int lazy_init_cnt;
+
+#endif /* _ZERV_TEST_LAZY_H_ */
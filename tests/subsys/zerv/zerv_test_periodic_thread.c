@@ -62,4 +62,5 @@ ZERV_MSG_HANDLER_DEF(async_timeout, msg)
 ZERV_TOPIC_HANDLER(periodic_service, test_topic, msg)
 {
 	LOG_DBG("Received test_topic: a=%d, b=%u, c=%c", msg->a, msg->b, msg->c);
+	k_sem_give(&test_topic_sem);
 }
\ No newline at end of file
@@ -0,0 +1,51 @@
+/*=================================================================================================
+ *
+ *           ██████╗ ██╗████████╗███╗   ███╗ █████╗ ███╗   ██╗     █████╗ ██████╗
+ *           ██╔══██╗██║╚══██╔══╝████╗ ████║██╔══██╗████╗  ██║    ██╔══██╗██╔══██╗
+ *           ██████╔╝██║   ██║   ██╔████╔██║███████║██╔██╗ ██║    ███████║██████╔╝
+ *           ██╔══██╗██║   ██║   ██║╚██╔╝██║██╔══██║██║╚██╗██║    ██╔══██║██╔══██╗
+ *           ██████╔╝██║   ██║   ██║ ╚═╝ ██║██║  ██║██║ ╚████║    ██║  ██║██████╔╝
+ *           ╚═════╝ ╚═╝   ╚═╝   ╚═╝     ╚═╝╚═╝  ╚═╝╚═╝  ╚═══╝    ╚═╝  ╚═╝╚═════╝
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * Copyright (c) 2023 BitMan AB
+ * contact: albin@bitman.se
+ *===============================================================================================*/
+#include <zephyr/ztest.h>
+#include <zephyr/kernel.h>
+#include <zephyr/zerv/zerv.h>
+#include <zephyr/zerv/zerv_internal.h>
+#include <zephyr/auxiliary/utils.h>
+
+ZTEST(zerv, test_placement)
+{
+	uint32_t all = BIT_MASK(arch_num_cpus());
+	uint32_t rt = 0;
+#if CONFIG_ZERV_RT_CPU >= 0
+	rt = BIT(CONFIG_ZERV_RT_CPU) & all;
+#endif
+	uint32_t shared = (all & ~rt) != 0 ? all & ~rt : all;
+	uint32_t shared_cnt = __builtin_popcount(shared);
+
+	// A real-time zervice gets the real-time CPU to itself.
+	zassert_equal(zerv_internal_placement_resolve(ZERV_PLACE_RT), rt != 0 ? rt : shared, NULL);
+
+	// The groups are dealt out one CPU each, round-robin over the CPUs other than the real-time
+	// one, so the first groups cover all of them once.
+	uint32_t covered = 0;
+	for (uint32_t group = 0; group < shared_cnt; group++) {
+		uint32_t mask = zerv_internal_placement_resolve(ZERV_PLACE_GROUP(group));
+		zassert_equal(__builtin_popcount(mask), 1, "Group %u is on CPUs 0x%x", group, mask);
+		zassert_equal(mask & ~shared, 0, "Group %u is on the real-time CPU", group);
+		zassert_equal(mask & covered, 0, "Group %u shares a CPU", group);
+		covered |= mask;
+
+		zassert_equal(zerv_internal_placement_resolve(ZERV_PLACE_GROUP(group + shared_cnt)),
+			      mask, "Group %u is not dealt round-robin", group + shared_cnt);
+	}
+	zassert_equal(covered, shared, NULL);
+
+	// A mask of CPUs is kept as it is.
+	zassert_equal(zerv_internal_placement_resolve(ZERV_PLACE_CPUS(BIT(0))), BIT(0), NULL);
+	PRINTLN("OK");
+}
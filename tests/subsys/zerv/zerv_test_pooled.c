@@ -0,0 +1,66 @@
+/*=================================================================================================
+ *
+ *           ██████╗ ██╗████████╗███╗   ███╗ █████╗ ███╗   ██╗     █████╗ ██████╗
+ *           ██╔══██╗██║╚══██╔══╝████╗ ████║██╔══██╗████╗  ██║    ██╔══██╗██╔══██╗
+ *           ██████╔╝██║   ██║   ██╔████╔██║███████║██╔██╗ ██║    ███████║██████╔╝
+ *           ██╔══██╗██║   ██║   ██║╚██╔╝██║██╔══██║██║╚██╗██║    ██╔══██║██╔══██╗
+ *           ██████╔╝██║   ██║   ██║ ╚═╝ ██║██║  ██║██║ ╚████║    ██║  ██║██████╔╝
+ *           ╚═════╝ ╚═╝   ╚═╝   ╚═╝     ╚═╝╚═╝  ╚═╝╚═╝  ╚═══╝    ╚═╝  ╚═╝╚═════╝
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * Copyright (c) 2023 BitMan AB
+ * contact: albin@bitman.se
+ *===============================================================================================*/
+#include "zerv_test_pooled.h"
+
+#include <zephyr/logging/log.h>
+
+LOG_MODULE_REGISTER(pooled, CONFIG_ZERV_LOG_LEVEL);
+
+K_SEM_DEFINE(pooled_init_sem, 0, 1);
+K_SEM_DEFINE(pooled_ping_sem, 0, 16);
+
+static atomic_t pooled_running = ATOMIC_INIT(0);
+static uint32_t pooled_handled = 0;
+static uint32_t pooled_overlaps = 0;
+static atomic_t pooled_pings_during_work = ATOMIC_INIT(0);
+
+static int init(void)
+{
+	LOG_DBG("Pooled service initialized");
+	k_sem_give(&pooled_init_sem);
+	return 0;
+}
+
+ZERV_DEF_POOLED(pooled_service, 2048, init);
+ZERV_DEF_POOLED(pooled_idle_service, 256, NULL);
+
+ZERV_MSG_HANDLER_DEF(pooled_work, msg)
+{
+	// Any other handler of the zervice running meanwhile would be running on another worker.
+	if (atomic_inc(&pooled_running) != 0) {
+		pooled_overlaps++;
+	}
+	// The handler sleeps rather than spins, so that the other worker gets the CPU meanwhile
+	// even without SMP.
+	k_usleep(100 * msg->n);
+	pooled_handled++;
+	atomic_dec(&pooled_running);
+}
+
+ZERV_CMD_HANDLER_DEF(pooled_stats, in, out)
+{
+	out->handled = pooled_handled;
+	out->overlaps = pooled_overlaps;
+	out->pings_during_work = atomic_get(&pooled_pings_during_work);
+	return 0;
+}
+
+ZERV_MSG_HANDLER_DEF(pooled_ping, msg)
+{
+	LOG_DBG("Received pooled_ping: %u", msg->n);
+	if (atomic_get(&pooled_running) != 0) {
+		atomic_inc(&pooled_pings_during_work);
+	}
+	k_sem_give(&pooled_ping_sem);
+}
@@ -0,0 +1,34 @@
+/*=================================================================================================
+ *
+ *           ██████╗ ██╗████████╗███╗   ███╗ █████╗ ███╗   ██╗     █████╗ ██████╗
+ *           ██╔══██╗██║╚══██╔══╝████╗ ████║██╔══██╗████╗  ██║    ██╔══██╗██╔══██╗
+ *           ██████╔╝██║   ██║   ██╔████╔██║███████║██╔██╗ ██║    ███████║██████╔╝
+ *           ██╔══██╗██║   ██║   ██║╚██╔╝██║██╔══██║██║╚██╗██║    ██╔══██║██╔══██╗
+ *           ██████╔╝██║   ██║   ██║ ╚═╝ ██║██║  ██║██║ ╚████║    ██║  ██║██████╔╝
+ *           ╚═════╝ ╚═╝   ╚═╝   ╚═╝     ╚═╝╚═╝  ╚═╝╚═╝  ╚═══╝    ╚═╝  ╚═╝╚═════╝
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * Copyright (c) 2023 BitMan AB
+ * contact: albin@bitman.se
+ *===============================================================================================*/
+#ifndef _ZERV_TEST_POOLED_H_
+#define _ZERV_TEST_POOLED_H_
+
+#include <zephyr/kernel.h>
+#include <zephyr/zerv/zerv.h>
+#include <zephyr/zerv/zerv_cmd.h>
+#include <zephyr/zerv/zerv_msg.h>
+
+extern struct k_sem pooled_init_sem;
+extern struct k_sem pooled_ping_sem;
+
+ZERV_MSG_DECL(pooled_work, uint32_t n);
+ZERV_CMD_DECL(pooled_stats, ZERV_IN_EMPTY,
+	      ZERV_OUT(uint32_t handled, uint32_t overlaps, uint32_t pings_during_work));
+ZERV_MSG_DECL(pooled_ping, uint32_t n);
+
+// Two zervices sharing the worker threads of the zervice pool.
+ZERV_DECL(pooled_service, ZERV_CMDS(pooled_stats), ZERV_MSGS(pooled_work), EMPTY);
+ZERV_DECL(pooled_idle_service, EMPTY, ZERV_MSGS(pooled_ping), EMPTY);
+
+#endif /* _ZERV_TEST_POOLED_H_ */
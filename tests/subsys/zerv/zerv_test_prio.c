@@ -0,0 +1,35 @@
+/*=================================================================================================
+ *
+ *           ██████╗ ██╗████████╗███╗   ███╗ █████╗ ███╗   ██╗     █████╗ ██████╗
+ *           ██╔══██╗██║╚══██╔══╝████╗ ████║██╔══██╗████╗  ██║    ██╔══██╗██╔══██╗
+ *           ██████╔╝██║   ██║   ██╔████╔██║███████║██╔██╗ ██║    ███████║██████╔╝
+ *           ██╔══██╗██║   ██║   ██║╚██╔╝██║██╔══██║██║╚██╗██║    ██╔══██║██╔══██╗
+ *           ██████╔╝██║   ██║   ██║ ╚═╝ ██║██║  ██║██║ ╚████║    ██║  ██║██████╔╝
+ *           ╚═════╝ ╚═╝   ╚═╝   ╚═╝     ╚═╝╚═╝  ╚═╝╚═╝  ╚═══╝    ╚═╝  ╚═╝╚═════╝
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * Copyright (c) 2023 BitMan AB
+ * contact: albin@bitman.se
+ *===============================================================================================*/
+#include "zerv_test_prio.h"
+
+#include <zephyr/logging/log.h>
+
+LOG_MODULE_REGISTER(prio, CONFIG_ZERV_LOG_LEVEL);
+
+k_tid_t prio_service_tid;
+
+static int prio_service_init(void)
+{
+	prio_service_tid = k_current_get();
+	return 0;
+}
+
+ZERV_DEF_THREAD(prio_service, 256, 1024, PRIO_SERVICE_PRIO, prio_service_init);
+
+ZERV_CMD_HANDLER_DEF(prio_work, in, out)
+{
+	k_busy_wait(in->work_us);
+	out->prio = k_thread_priority_get(k_current_get());
+	return 0;
+}
@@ -0,0 +1,31 @@
+/*=================================================================================================
+ *
+ *           ██████╗ ██╗████████╗███╗   ███╗ █████╗ ███╗   ██╗     █████╗ ██████╗
+ *           ██╔══██╗██║╚══██╔══╝████╗ ████║██╔══██╗████╗  ██║    ██╔══██╗██╔══██╗
+ *           ██████╔╝██║   ██║   ██╔████╔██║███████║██╔██╗ ██║    ███████║██████╔╝
+ *           ██╔══██╗██║   ██║   ██║╚██╔╝██║██╔══██║██║╚██╗██║    ██╔══██║██╔══██╗
+ *           ██████╔╝██║   ██║   ██║ ╚═╝ ██║██║  ██║██║ ╚████║    ██║  ██║██████╔╝
+ *           ╚═════╝ ╚═╝   ╚═╝   ╚═╝     ╚═╝╚═╝  ╚═╝╚═╝  ╚═══╝    ╚═╝  ╚═╝╚═════╝
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * Copyright (c) 2023 BitMan AB
+ * contact: albin@bitman.se
+ *===============================================================================================*/
+#ifndef _ZERV_TEST_PRIO_H_
+#define _ZERV_TEST_PRIO_H_
+
+#include <zephyr/kernel.h>
+#include <zephyr/zerv/zerv.h>
+#include <zephyr/zerv/zerv_cmd.h>
+
+#define PRIO_SERVICE_PRIO K_PRIO_PREEMPT(12)
+
+// Busy works for a while on the zervice thread and returns the priority it ran at.
+ZERV_CMD_DECL(prio_work, ZERV_IN(uint32_t work_us), ZERV_OUT(int prio));
+
+// A low priority zervice called by a high priority thread.
+ZERV_DECL(prio_service, ZERV_CMDS(prio_work), EMPTY, EMPTY);
+
+extern k_tid_t prio_service_tid;
+
+#endif /* _ZERV_TEST_PRIO_H_ */
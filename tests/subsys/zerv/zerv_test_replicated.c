@@ -0,0 +1,62 @@
+/*=================================================================================================
+ *
+ *           ██████╗ ██╗████████╗███╗   ███╗ █████╗ ███╗   ██╗     █████╗ ██████╗
+ *           ██╔══██╗██║╚══██╔══╝████╗ ████║██╔══██╗████╗  ██║    ██╔══██╗██╔══██╗
+ *           ██████╔╝██║   ██║   ██╔████╔██║███████║██╔██╗ ██║    ███████║██████╔╝
+ *           ██╔══██╗██║   ██║   ██║╚██╔╝██║██╔══██║██║╚██╗██║    ██╔══██║██╔══██╗
+ *           ██████╔╝██║   ██║   ██║ ╚═╝ ██║██║  ██║██║ ╚████║    ██║  ██║██████╔╝
+ *           ╚═════╝ ╚═╝   ╚═╝   ╚═╝     ╚═╝╚═╝  ╚═╝╚═╝  ╚═══╝    ╚═╝  ╚═╝╚═════╝
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * Copyright (c) 2023 BitMan AB
+ * contact: albin@bitman.se
+ *===============================================================================================*/
+#include "zerv_test_replicated.h"
+
+#include <zephyr/logging/log.h>
+
+LOG_MODULE_REGISTER(replicated, CONFIG_ZERV_LOG_LEVEL);
+
+static atomic_t repl_parallel = ATOMIC_INIT(0);
+static atomic_t repl_exclusive = ATOMIC_INIT(0);
+static atomic_t repl_overlaps = ATOMIC_INIT(0);
+static uint32_t repl_next_seq = 0;
+static uint32_t repl_handled = 0;
+static uint32_t repl_reordered = 0;
+
+ZERV_DEF_REPLICATED(replicated_service, 1024, 1024, K_PRIO_PREEMPT(10), 2, NULL);
+
+ZERV_CMD_HANDLER_DEF(repl_work, in, out)
+{
+	atomic_inc(&repl_parallel);
+	if (atomic_get(&repl_exclusive) != 0) {
+		atomic_inc(&repl_overlaps);
+	}
+	k_busy_wait(100);
+	out->n = in->n;
+	atomic_dec(&repl_parallel);
+	return 0;
+}
+
+ZERV_CMD_HANDLER_DEF(repl_stats, in, out)
+{
+	out->handled = repl_handled;
+	out->reordered = repl_reordered;
+	out->overlaps = atomic_get(&repl_overlaps);
+	return 0;
+}
+
+ZERV_MSG_HANDLER_DEF(repl_seq, msg)
+{
+	// An exclusive request never runs beside another request of the zervice.
+	if (atomic_inc(&repl_exclusive) != 0 || atomic_get(&repl_parallel) != 0) {
+		atomic_inc(&repl_overlaps);
+	}
+	if (msg->seq != repl_next_seq) {
+		repl_reordered++;
+	}
+	repl_next_seq = msg->seq + 1;
+	repl_handled++;
+	k_busy_wait(50);
+	atomic_dec(&repl_exclusive);
+}
@@ -0,0 +1,30 @@
+/*=================================================================================================
+ *
+ *           ██████╗ ██╗████████╗███╗   ███╗ █████╗ ███╗   ██╗     █████╗ ██████╗
+ *           ██╔══██╗██║╚══██╔══╝████╗ ████║██╔══██╗████╗  ██║    ██╔══██╗██╔══██╗
+ *           ██████╔╝██║   ██║   ██╔████╔██║███████║██╔██╗ ██║    ███████║██████╔╝
+ *           ██╔══██╗██║   ██║   ██║╚██╔╝██║██╔══██║██║╚██╗██║    ██╔══██║██╔══██╗
+ *           ██████╔╝██║   ██║   ██║ ╚═╝ ██║██║  ██║██║ ╚████║    ██║  ██║██████╔╝
+ *           ╚═════╝ ╚═╝   ╚═╝   ╚═╝     ╚═╝╚═╝  ╚═╝╚═╝  ╚═══╝    ╚═╝  ╚═╝╚═════╝
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * Copyright (c) 2023 BitMan AB
+ * contact: albin@bitman.se
+ *===============================================================================================*/
+#ifndef _ZERV_TEST_REPLICATED_H_
+#define _ZERV_TEST_REPLICATED_H_
+
+#include <zephyr/kernel.h>
+#include <zephyr/zerv/zerv.h>
+#include <zephyr/zerv/zerv_cmd.h>
+#include <zephyr/zerv/zerv_msg.h>
+
+ZERV_CMD_DECL_PARALLEL(repl_work, ZERV_IN(uint32_t n), ZERV_OUT(uint32_t n));
+ZERV_CMD_DECL(repl_stats, ZERV_IN_EMPTY,
+	      ZERV_OUT(uint32_t handled, uint32_t reordered, uint32_t overlaps));
+ZERV_MSG_DECL(repl_seq, uint32_t seq);
+
+// A zervice handled by two worker threads.
+ZERV_DECL(replicated_service, ZERV_CMDS(repl_work, repl_stats), ZERV_MSGS(repl_seq), EMPTY);
+
+#endif /* _ZERV_TEST_REPLICATED_H_ */
@@ -6,6 +6,17 @@
 LOG_MODULE_REGISTER(zerv_test_service, LOG_LEVEL_DBG);
 
 K_SEM_DEFINE(test_msg_sem, 0, 1);
+K_SEM_DEFINE(history_topic_sem, 0, 4);
+
+int history_topic_seqs[16];
+size_t history_topic_recv_cnt;
+
+K_SEM_DEFINE(any_imu_accel_sem, 0, 1);
+int any_imu_accel_last_imu = -1;
+
+K_SEM_DEFINE(batch_topic_block_sem, 0, 1);
+size_t batch_topic_block_cnt;
+int batch_topic_block_sum;
 
 ZERV_DEF_THREAD(zerv_test_service, 256, 256, K_PRIO_PREEMPT(10), NULL);
 
@@ -44,6 +55,26 @@ ZERV_CMD_HANDLER_DEF(print_hello_world, req, resp)
 	return ZERV_RC_OK;
 }
 
+ZERV_STATE_DEF(zerv_test_service, test_mode, struct test_mode);
+
+static struct test_mode current_test_mode;
+k_tid_t get_test_mode_thread;
+
+ZERV_CMD_HANDLER_DEF(set_test_mode, req, resp)
+{
+	current_test_mode.mode = req->mode;
+	current_test_mode.gain = req->gain;
+	return ZERV_STATE_PUBLISH(test_mode, &current_test_mode);
+}
+
+ZERV_CMD_HANDLER_DEF(get_test_mode, req, resp)
+{
+	get_test_mode_thread = k_current_get();
+	resp->mode = current_test_mode.mode;
+	resp->gain = current_test_mode.gain;
+	return ZERV_RC_OK;
+}
+
 ZERV_MSG_HANDLER_DEF(test_msg, msg)
 {
 	LOG_DBG("Received message: str: %s, a: %d, b: %d", msg->str, msg->a, msg->b);
@@ -53,4 +84,32 @@ ZERV_MSG_HANDLER_DEF(test_msg, msg)
 ZERV_TOPIC_HANDLER(zerv_test_service, test_topic, msg)
 {
 	LOG_DBG("Received test_topic: a=%d, b=%u, c=%c", msg->a, msg->b, msg->c);
+	k_sem_give(&test_topic_sem);
+}
+
+ZERV_TOPIC_HANDLER(zerv_test_service, history_topic, msg)
+{
+	LOG_DBG("Received history_topic: seq=%d", msg->seq);
+	if (history_topic_recv_cnt < ARRAY_SIZE(history_topic_seqs)) {
+		history_topic_seqs[history_topic_recv_cnt++] = msg->seq;
+	}
+	k_sem_give(&history_topic_sem);
+}
+
+ZERV_TOPIC_HANDLER(zerv_test_service, any_imu_accel, msg)
+{
+	LOG_DBG("Received any_imu_accel: imu=%d, value=%d", msg->imu, msg->value);
+	any_imu_accel_last_imu = msg->imu;
+	k_sem_give(&any_imu_accel_sem);
+}
+
+ZERV_TOPIC_BATCH_HANDLER(zerv_test_service, batch_topic, samples, cnt)
+{
+	LOG_DBG("Received batch_topic block of %d samples", cnt);
+	batch_topic_block_cnt = cnt;
+	batch_topic_block_sum = 0;
+	for (size_t i = 0; i < cnt; i++) {
+		batch_topic_block_sum += samples[i].sample;
+	}
+	k_sem_give(&batch_topic_block_sem);
 }
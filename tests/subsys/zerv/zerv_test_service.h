@@ -7,8 +7,18 @@
 #include <zephyr/zerv/zerv.h>
 #include <zephyr/zerv/zerv_cmd.h>
 #include <zephyr/zerv/zerv_msg.h>
+#include <zephyr/zerv/zerv_state.h>
 
 extern struct k_sem test_msg_sem;
+extern struct k_sem history_topic_sem;
+extern int history_topic_seqs[16];
+extern size_t history_topic_recv_cnt;
+extern k_tid_t get_test_mode_thread;
+extern struct k_sem any_imu_accel_sem;
+extern int any_imu_accel_last_imu;
+extern struct k_sem batch_topic_block_sem;
+extern size_t batch_topic_block_cnt;
+extern int batch_topic_block_sum;
 
 // Define a requests of the service that will retrieve the string "Hello World!" and respond with
 // the integers a and b.
@@ -26,11 +36,26 @@ ZERV_CMD_DECL(read_hello_world, ZERV_IN_EMPTY, ZERV_OUT(char str[30]));
 // Define a request that will print the string "Hello World!".
 ZERV_CMD_DECL(print_hello_world, ZERV_IN_EMPTY, ZERV_OUT_EMPTY);
 
+// Define a request that will set the mode published in the test_mode state.
+ZERV_CMD_DECL(set_test_mode, ZERV_IN(int32_t mode, uint32_t gain), ZERV_OUT_EMPTY);
+
+// Define a read-only request that is handled on the calling thread.
+ZERV_CMD_DECL_CONST(get_test_mode, ZERV_IN_EMPTY, ZERV_OUT(int32_t mode, uint32_t gain));
+
 ZERV_MSG_DECL(test_msg, char str[30], int32_t a, int32_t b);
 
+// The mode of the service, readable by any thread without calling the service.
+struct test_mode {
+	int32_t mode;
+	uint32_t gain;
+};
+ZERV_STATE_DECL(test_mode, struct test_mode);
+
 // Declare the service.
 ZERV_DECL(zerv_test_service,
-	  ZERV_CMDS(get_hello_world, echo, fail, read_hello_world, print_hello_world),
-	  ZERV_MSGS(test_msg), ZERV_SUBSCRIBED_TOPICS(test_topic));
+	  ZERV_CMDS(get_hello_world, echo, fail, read_hello_world, print_hello_world,
+		    set_test_mode, get_test_mode),
+	  ZERV_MSGS(test_msg),
+	  ZERV_SUBSCRIBED_TOPICS(test_topic, history_topic, any_imu_accel, batch_topic));
 
 #endif // _ZERV_TEST_SERVICE_H_
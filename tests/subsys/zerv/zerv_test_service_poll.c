@@ -68,4 +68,5 @@ ZERV_CMD_HANDLER_DEF(fail2, req, resp)
 ZERV_TOPIC_HANDLER(zerv_poll_service_2, test_topic, msg)
 {
 	LOG_DBG("Received test_topic: a=%d, b=%u, c=%c", msg->a, msg->b, msg->c);
+	k_sem_give(&test_topic_sem);
 }
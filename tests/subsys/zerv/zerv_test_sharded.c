@@ -0,0 +1,68 @@
+/*=================================================================================================
+ *
+ *           ██████╗ ██╗████████╗███╗   ███╗ █████╗ ███╗   ██╗     █████╗ ██████╗
+ *           ██╔══██╗██║╚══██╔══╝████╗ ████║██╔══██╗████╗  ██║    ██╔══██╗██╔══██╗
+ *           ██████╔╝██║   ██║   ██╔████╔██║███████║██╔██╗ ██║    ███████║██████╔╝
+ *           ██╔══██╗██║   ██║   ██║╚██╔╝██║██╔══██║██║╚██╗██║    ██╔══██║██╔══██╗
+ *           ██████╔╝██║   ██║   ██║ ╚═╝ ██║██║  ██║██║ ╚████║    ██║  ██║██████╔╝
+ *           ╚═════╝ ╚═╝   ╚═╝   ╚═╝     ╚═╝╚═╝  ╚═╝╚═╝  ╚═══╝    ╚═╝  ╚═╝╚═════╝
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * Copyright (c) 2023 BitMan AB
+ * contact: albin@bitman.se
+ *===============================================================================================*/
+#include "zerv_test_sharded.h"
+#include "zerv_test_init.h"
+
+#include <zephyr/logging/log.h>
+
+LOG_MODULE_REGISTER(sharded, CONFIG_ZERV_LOG_LEVEL);
+
+atomic_t sharded_early_inits;
+
+// Each shard only ever touches the values of its own keys.
+static uint32_t sharded_values[SHARDED_KEY_CNT];
+
+static uint32_t sharded_key(const void *params, size_t params_len)
+{
+	return *(const uint32_t *)params;
+}
+
+static int sharded_init(void)
+{
+	if (!atomic_get(&init_base_done)) {
+		atomic_inc(&sharded_early_inits);
+	}
+	return 0;
+}
+
+ZERV_DEF_SHARDED(sharded_service, 256, 1024, K_PRIO_PREEMPT(10), 2, sharded_key, sharded_init);
+
+ZERV_INIT_AFTER(sharded_service, init_base);
+
+ZERV_CMD_HANDLER_DEF(shard_put, in, out)
+{
+	if (in->key >= SHARDED_KEY_CNT) {
+		return ZERV_RC_ERROR;
+	}
+	sharded_values[in->key] = in->value;
+	out->shard = zerv_shard_index(&sharded_service);
+	return 0;
+}
+
+ZERV_CMD_HANDLER_DEF(shard_get, in, out)
+{
+	if (in->key >= SHARDED_KEY_CNT) {
+		return ZERV_RC_ERROR;
+	}
+	out->value = sharded_values[in->key];
+	out->shard = zerv_shard_index(&sharded_service);
+	return 0;
+}
+
+ZERV_MSG_HANDLER_DEF(shard_clear, msg)
+{
+	if (msg->key < SHARDED_KEY_CNT) {
+		sharded_values[msg->key] = 0;
+	}
+}
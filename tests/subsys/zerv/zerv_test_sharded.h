@@ -0,0 +1,35 @@
+/*=================================================================================================
+ *
+ *           ██████╗ ██╗████████╗███╗   ███╗ █████╗ ███╗   ██╗     █████╗ ██████╗
+ *           ██╔══██╗██║╚══██╔══╝████╗ ████║██╔══██╗████╗  ██║    ██╔══██╗██╔══██╗
+ *           ██████╔╝██║   ██║   ██╔████╔██║███████║██╔██╗ ██║    ███████║██████╔╝
+ *           ██╔══██╗██║   ██║   ██║╚██╔╝██║██╔══██║██║╚██╗██║    ██╔══██║██╔══██╗
+ *           ██████╔╝██║   ██║   ██║ ╚═╝ ██║██║  ██║██║ ╚████║    ██║  ██║██████╔╝
+ *           ╚═════╝ ╚═╝   ╚═╝   ╚═╝     ╚═╝╚═╝  ╚═╝╚═╝  ╚═══╝    ╚═╝  ╚═╝╚═════╝
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * Copyright (c) 2023 BitMan AB
+ * contact: albin@bitman.se
+ *===============================================================================================*/
+#ifndef _ZERV_TEST_SHARDED_H_
+#define _ZERV_TEST_SHARDED_H_
+
+#include <zephyr/kernel.h>
+#include <zephyr/zerv/zerv.h>
+#include <zephyr/zerv/zerv_cmd.h>
+#include <zephyr/zerv/zerv_msg.h>
+
+#define SHARDED_KEY_CNT 8
+
+// The number of shards initialized before init_base, which they are initialized after.
+extern atomic_t sharded_early_inits;
+
+// The key leads the parameters of every request of the sharded zervice.
+ZERV_CMD_DECL(shard_put, ZERV_IN(uint32_t key, uint32_t value), ZERV_OUT(int shard));
+ZERV_CMD_DECL(shard_get, ZERV_IN(uint32_t key), ZERV_OUT(int shard, uint32_t value));
+ZERV_MSG_DECL(shard_clear, uint32_t key);
+
+// A zervice partitioned over two shards by the key of the requests.
+ZERV_DECL(sharded_service, ZERV_CMDS(shard_put, shard_get), ZERV_MSGS(shard_clear), EMPTY);
+
+#endif /* _ZERV_TEST_SHARDED_H_ */
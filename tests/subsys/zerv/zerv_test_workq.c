@@ -0,0 +1,37 @@
+/*=================================================================================================
+ *
+ *           ██████╗ ██╗████████╗███╗   ███╗ █████╗ ███╗   ██╗     █████╗ ██████╗
+ *           ██╔══██╗██║╚══██╔══╝████╗ ████║██╔══██╗████╗  ██║    ██╔══██╗██╔══██╗
+ *           ██████╔╝██║   ██║   ██╔████╔██║███████║██╔██╗ ██║    ███████║██████╔╝
+ *           ██╔══██╗██║   ██║   ██║╚██╔╝██║██╔══██║██║╚██╗██║    ██╔══██║██╔══██╗
+ *           ██████╔╝██║   ██║   ██║ ╚═╝ ██║██║  ██║██║ ╚████║    ██║  ██║██████╔╝
+ *           ╚═════╝ ╚═╝   ╚═╝   ╚═╝     ╚═╝╚═╝  ╚═╝╚═╝  ╚═══╝    ╚═╝  ╚═╝╚═════╝
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * Copyright (c) 2023 BitMan AB
+ * contact: albin@bitman.se
+ *===============================================================================================*/
+#include "zerv_test_workq.h"
+
+#include <zephyr/logging/log.h>
+
+LOG_MODULE_REGISTER(workq, CONFIG_ZERV_LOG_LEVEL);
+
+k_tid_t workq_echo_thread = NULL;
+static uint32_t workq_handled = 0;
+
+ZERV_DEF_WORKQ(workq_service, 1024, NULL);
+
+ZERV_CMD_HANDLER_DEF(workq_echo, in, out)
+{
+	workq_echo_thread = k_current_get();
+	out->n = in->n;
+	out->handled = workq_handled;
+	return 0;
+}
+
+ZERV_MSG_HANDLER_DEF(workq_count, msg)
+{
+	LOG_DBG("Received workq_count: %u", msg->n);
+	workq_handled++;
+}
@@ -0,0 +1,30 @@
+/*=================================================================================================
+ *
+ *           ██████╗ ██╗████████╗███╗   ███╗ █████╗ ███╗   ██╗     █████╗ ██████╗
+ *           ██╔══██╗██║╚══██╔══╝████╗ ████║██╔══██╗████╗  ██║    ██╔══██╗██╔══██╗
+ *           ██████╔╝██║   ██║   ██╔████╔██║███████║██╔██╗ ██║    ███████║██████╔╝
+ *           ██╔══██╗██║   ██║   ██║╚██╔╝██║██╔══██║██║╚██╗██║    ██╔══██║██╔══██╗
+ *           ██████╔╝██║   ██║   ██║ ╚═╝ ██║██║  ██║██║ ╚████║    ██║  ██║██████╔╝
+ *           ╚═════╝ ╚═╝   ╚═╝   ╚═╝     ╚═╝╚═╝  ╚═╝╚═╝  ╚═══╝    ╚═╝  ╚═╝╚═════╝
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * Copyright (c) 2023 BitMan AB
+ * contact: albin@bitman.se
+ *===============================================================================================*/
+#ifndef _ZERV_TEST_WORKQ_H_
+#define _ZERV_TEST_WORKQ_H_
+
+#include <zephyr/kernel.h>
+#include <zephyr/zerv/zerv.h>
+#include <zephyr/zerv/zerv_cmd.h>
+#include <zephyr/zerv/zerv_msg.h>
+
+extern k_tid_t workq_echo_thread;
+
+ZERV_CMD_DECL(workq_echo, ZERV_IN(uint32_t n), ZERV_OUT(uint32_t n, uint32_t handled));
+ZERV_MSG_DECL(workq_count, uint32_t n);
+
+// A zervice run on the system work queue, without a thread of its own.
+ZERV_DECL(workq_service, ZERV_CMDS(workq_echo), ZERV_MSGS(workq_count), EMPTY);
+
+#endif /* _ZERV_TEST_WORKQ_H_ */